@@ -0,0 +1,347 @@
+/**********************************
+
+## Licence
+
+ Licence Creative Commons CC BY-NC-SA 
+
+## Auteurs et contributions
+
+- **Code original dec406_v7** : F4EHY (2020)
+- **Refactoring et support 2G** : Développement collaboratif (2025)
+- **Conformité T.018** : Implémentation complète BCH + MID database
+
+***********************************/
+
+// acq_2g.c - FFT code-phase acquisition of 2G bursts, carrier bins in parallel
+//
+// Samples are averaged in pairs to 2 per chip and cut into overlapping
+// blocks of ACQ2G_N (overlap-save, half a block of new samples each time).
+// One forward FFT per block; a carrier bin is a circular shift of that
+// spectrum. Multiplied by the precomputed conjugate spectrum of a
+// preamble segment and transformed back, it gives the correlation at all
+// 512 code phases of the block at once.
+//
+// Segment m of a start is seen m blocks later at the same code phase, so
+// segment powers are kept for ACQ2G_SEGMENTS blocks and summed once the
+// last one is in, each over the noise floor of its own block. The bins
+// are dealt to worker threads; the caller's thread is worker 0.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "acq_2g.h"
+#include "demod_2g.h"
+#include "fft.h"
+
+// New samples per block: half the FFT, also one segment at 2 per chip
+#define ACQ2G_PAS (ACQ2G_N / 2)
+
+typedef struct {
+    Acq2G *a;
+    int id;
+    float *y_re;                        // Correlation scratch
+    float *y_im;
+    double somme[ACQ2G_SEGMENTS];       // Power summed over the bins done
+} OuvrierAcq;
+
+struct Acq2G {
+    int k_max;                  // Bins -k_max to k_max
+    int n_canaux;
+    double pas_hz;              // Bin spacing (Hz)
+    PlanFFT plan;
+    // Conjugate spectra of the preamble segments
+    float *ref_re[ACQ2G_SEGMENTS];
+    float *ref_im[ACQ2G_SEGMENTS];
+    // Time buffer at 2 samples per chip and its spectrum
+    float x_re[ACQ2G_N];
+    float x_im[ACQ2G_N];
+    float s_re[ACQ2G_N];
+    float s_im[ACQ2G_N];
+    int n_x;                    // New samples in the second half
+    float paire_re;             // First sample of the current pair
+    float paire_im;
+    int demi;
+    // Segment powers [block % segments][segment][bin][code phase]
+    float *puissance;
+    double bruit[ACQ2G_SEGMENTS][ACQ2G_SEGMENTS];
+    long long bloc;             // Blocks processed
+    // Workers
+    int n_fils;
+    OuvrierAcq *ouvriers;
+    pthread_t *fils;
+    pthread_mutex_t verrou;
+    pthread_cond_t travail;
+    pthread_cond_t fini;
+    long long generation;
+    int restants;
+    int arret;
+    int demarre;                // Workers and their locks are set up
+};
+
+static inline float *puissance(Acq2G *a, long long bloc, int m, int canal) {
+    return a->puissance + (((bloc % ACQ2G_SEGMENTS) * ACQ2G_SEGMENTS + m) * a->n_canaux + canal)
+                          * (size_t)ACQ2G_PAS;
+}
+
+// ===================================================
+// Correlation of the bins of one worker
+// ===================================================
+static void correle_canaux(OuvrierAcq *o) {
+    Acq2G *a = o->a;
+    int c, m, f, t;
+
+    for (m = 0; m < ACQ2G_SEGMENTS; m++) o->somme[m] = 0.0;
+    for (c = o->id; c < a->n_canaux; c += a->n_fils) {
+        int k = c - a->k_max;
+        for (m = 0; m < ACQ2G_SEGMENTS; m++) {
+            const float *rr = a->ref_re[m], *ri = a->ref_im[m];
+            float *p = puissance(a, a->bloc, m, c);
+            double s = 0.0;
+
+            // Bin k: the spectrum shifted down by k, i.e. the block
+            // derotated by k * pas_hz
+            for (f = 0; f < ACQ2G_N; f++) {
+                int g = (f + k) & (ACQ2G_N - 1);
+                o->y_re[f] = a->s_re[g] * rr[f] - a->s_im[g] * ri[f];
+                o->y_im[f] = a->s_re[g] * ri[f] + a->s_im[g] * rr[f];
+            }
+            fft_calcule(&a->plan, o->y_re, o->y_im, 1);
+            for (t = 0; t < ACQ2G_PAS; t++) {
+                p[t] = o->y_re[t] * o->y_re[t] + o->y_im[t] * o->y_im[t];
+                s += p[t];
+            }
+            o->somme[m] += s;
+        }
+    }
+}
+
+static void *ouvrier_acq(void *arg) {
+    OuvrierAcq *o = arg;
+    Acq2G *a = o->a;
+    long long vue = 0;
+
+    for (;;) {
+        pthread_mutex_lock(&a->verrou);
+        while (!a->arret && a->generation == vue) {
+            pthread_cond_wait(&a->travail, &a->verrou);
+        }
+        if (a->arret) {
+            pthread_mutex_unlock(&a->verrou);
+            break;
+        }
+        vue = a->generation;
+        pthread_mutex_unlock(&a->verrou);
+
+        correle_canaux(o);
+
+        pthread_mutex_lock(&a->verrou);
+        if (--a->restants == 0) pthread_cond_signal(&a->fini);
+        pthread_mutex_unlock(&a->verrou);
+    }
+    return NULL;
+}
+
+// ===================================================
+// Creation
+// ===================================================
+Acq2G *acq2g_cree(const signed char *prn_i, const signed char *prn_q,
+                  double decalage_max, int n_fils) {
+    Acq2G *a = calloc(1, sizeof(Acq2G));
+    int m, n, i;
+
+    if (!a) return NULL;
+    a->pas_hz = 2.0 * SGB_DEBIT_CHIPS / ACQ2G_N;
+    a->k_max = (int)ceil(decalage_max / a->pas_hz);
+    a->n_canaux = 2 * a->k_max + 1;
+    if (n_fils <= 0) n_fils = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (n_fils < 1) n_fils = 1;
+    if (n_fils > a->n_canaux) n_fils = a->n_canaux;
+    a->n_fils = n_fils;
+
+    a->puissance = malloc((size_t)ACQ2G_SEGMENTS * ACQ2G_SEGMENTS * a->n_canaux
+                          * ACQ2G_PAS * sizeof(float));
+    a->ouvriers = calloc(n_fils, sizeof(OuvrierAcq));
+    a->fils = calloc(n_fils, sizeof(pthread_t));
+    if (!a->puissance || !a->ouvriers || !a->fils || fft_init(&a->plan, ACQ2G_N) != 0) {
+        acq2g_detruit(a);
+        return NULL;
+    }
+    for (m = 0; m < ACQ2G_SEGMENTS; m++) {
+        a->ref_re[m] = calloc(ACQ2G_N, sizeof(float));
+        a->ref_im[m] = calloc(ACQ2G_N, sizeof(float));
+        if (!a->ref_re[m] || !a->ref_im[m]) {
+            acq2g_detruit(a);
+            return NULL;
+        }
+        // Segment m at 2 samples per chip: I + jQ, Q half a chip late
+        for (n = 0; n < 2 * ACQ2G_CHIPS; n++) {
+            int c = m * ACQ2G_CHIPS + n / 2;
+            a->ref_re[m][n] = prn_i[c];
+            a->ref_im[m][n + 1] = prn_q[c];
+        }
+        fft_calcule(&a->plan, a->ref_re[m], a->ref_im[m], 0);
+        for (n = 0; n < ACQ2G_N; n++) a->ref_im[m][n] = -a->ref_im[m][n];
+    }
+    for (i = 0; i < n_fils; i++) {
+        OuvrierAcq *o = &a->ouvriers[i];
+        o->a = a;
+        o->id = i;
+        o->y_re = malloc(ACQ2G_N * sizeof(float));
+        o->y_im = malloc(ACQ2G_N * sizeof(float));
+        if (!o->y_re || !o->y_im) {
+            acq2g_detruit(a);
+            return NULL;
+        }
+    }
+
+    pthread_mutex_init(&a->verrou, NULL);
+    pthread_cond_init(&a->travail, NULL);
+    pthread_cond_init(&a->fini, NULL);
+    for (i = 1; i < n_fils; i++) {
+        pthread_create(&a->fils[i], NULL, ouvrier_acq, &a->ouvriers[i]);
+    }
+    a->demarre = 1;
+    return a;
+}
+
+void acq2g_detruit(Acq2G *a) {
+    int i, m;
+
+    if (!a) return;
+    if (a->demarre) {
+        pthread_mutex_lock(&a->verrou);
+        a->arret = 1;
+        pthread_cond_broadcast(&a->travail);
+        pthread_mutex_unlock(&a->verrou);
+        for (i = 1; i < a->n_fils; i++) pthread_join(a->fils[i], NULL);
+        pthread_mutex_destroy(&a->verrou);
+        pthread_cond_destroy(&a->travail);
+        pthread_cond_destroy(&a->fini);
+    }
+    if (a->ouvriers) {
+        for (i = 0; i < a->n_fils; i++) {
+            free(a->ouvriers[i].y_re);
+            free(a->ouvriers[i].y_im);
+        }
+    }
+    for (m = 0; m < ACQ2G_SEGMENTS; m++) {
+        free(a->ref_re[m]);
+        free(a->ref_im[m]);
+    }
+    fft_libere(&a->plan);
+    free(a->puissance);
+    free(a->ouvriers);
+    free(a->fils);
+    free(a);
+}
+
+void acq2g_affiche(const Acq2G *a) {
+    printf("FFT acquisition: %d code phases per block, %d bins %.0f Hz apart, "
+           "%d x %d chips, %d thread%s\n",
+           ACQ2G_PAS, a->n_canaux, a->pas_hz, ACQ2G_SEGMENTS, ACQ2G_CHIPS,
+           a->n_fils, a->n_fils > 1 ? "s" : "");
+}
+
+// ===================================================
+// Block processing
+// ===================================================
+// Vertex of the parabola through (-1, g), (0, c), (1, d)
+static double sommet(double g, double c, double d) {
+    double den = g - 2.0 * c + d;
+    return (den < 0.0) ? 0.5 * (g - d) / den : 0.0;
+}
+
+static double metrique(Acq2G *a, long long debut, int canal, int t) {
+    double s = 0.0;
+    int m;
+
+    for (m = 0; m < ACQ2G_SEGMENTS; m++) {
+        s += puissance(a, debut + m, m, canal)[t] / a->bruit[(debut + m) % ACQ2G_SEGMENTS][m];
+    }
+    return s / ACQ2G_SEGMENTS;
+}
+
+static int traite_bloc(Acq2G *a, DetectionSGB *det) {
+    long long debut = a->bloc - (ACQ2G_SEGMENTS - 1);
+    double meilleur = 0.0;
+    int canal = 0, t_max = 0;
+    int c, t, m, i;
+
+    memcpy(a->s_re, a->x_re, sizeof(a->s_re));
+    memcpy(a->s_im, a->x_im, sizeof(a->s_im));
+    fft_calcule(&a->plan, a->s_re, a->s_im, 0);
+
+    pthread_mutex_lock(&a->verrou);
+    a->restants = a->n_fils - 1;
+    a->generation++;
+    pthread_cond_broadcast(&a->travail);
+    pthread_mutex_unlock(&a->verrou);
+    correle_canaux(&a->ouvriers[0]);
+    pthread_mutex_lock(&a->verrou);
+    while (a->restants > 0) pthread_cond_wait(&a->fini, &a->verrou);
+    pthread_mutex_unlock(&a->verrou);
+
+    for (m = 0; m < ACQ2G_SEGMENTS; m++) {
+        double s = 0.0;
+        for (i = 0; i < a->n_fils; i++) s += a->ouvriers[i].somme[m];
+        s /= (double)a->n_canaux * ACQ2G_PAS;
+        a->bruit[a->bloc % ACQ2G_SEGMENTS][m] = (s > 0.0) ? s : 1.0;
+    }
+
+    // Starts of block debut: first half of that block's buffer
+    a->bloc++;
+    if (debut < 1) return 0;
+    for (c = 0; c < a->n_canaux; c++) {
+        for (t = 0; t < ACQ2G_PAS; t++) {
+            double v = metrique(a, debut, c, t);
+            if (v > meilleur) {
+                meilleur = v;
+                canal = c;
+                t_max = t;
+            }
+        }
+    }
+    if (meilleur < ACQ2G_SEUIL) return 0;
+
+    {
+        double dt = 0.0, dc = 0.0;
+        if (t_max > 0 && t_max < ACQ2G_PAS - 1) {
+            dt = sommet(metrique(a, debut, canal, t_max - 1), meilleur,
+                        metrique(a, debut, canal, t_max + 1));
+        }
+        if (canal > 0 && canal < a->n_canaux - 1) {
+            dc = sommet(metrique(a, debut, canal - 1, t_max), meilleur,
+                        metrique(a, debut, canal + 1, t_max));
+        }
+        det->phase_code = (t_max + dt) / 2.0;
+        det->debut = (long long)floor(2.0 * ((debut - 1) * ACQ2G_PAS + t_max + dt) + 0.5);
+        det->decalage = (canal - a->k_max + dc) * a->pas_hz;
+        det->metrique = meilleur;
+    }
+    return 1;
+}
+
+int acq2g_pousse(Acq2G *a, float re, float im, DetectionSGB *det) {
+    int n;
+
+    // Pairs of samples, so that a chip is two of them
+    if (!a->demi) {
+        a->paire_re = re;
+        a->paire_im = im;
+        a->demi = 1;
+        return 0;
+    }
+    a->demi = 0;
+    n = ACQ2G_PAS + a->n_x;
+    a->x_re[n] = 0.5f * (a->paire_re + re);
+    a->x_im[n] = 0.5f * (a->paire_im + im);
+    if (++a->n_x < ACQ2G_PAS) return 0;
+
+    n = traite_bloc(a, det);
+    memmove(a->x_re, a->x_re + ACQ2G_PAS, ACQ2G_PAS * sizeof(float));
+    memmove(a->x_im, a->x_im + ACQ2G_PAS, ACQ2G_PAS * sizeof(float));
+    a->n_x = 0;
+    return n;
+}
@@ -0,0 +1,73 @@
+/**********************************
+
+## Licence
+
+ Licence Creative Commons CC BY-NC-SA 
+
+## Auteurs et contributions
+
+- **Code original dec406_v7** : F4EHY (2020)
+- **Refactoring et support 2G** : Développement collaboratif (2025)
+- **Conformité T.018** : Implémentation complète BCH + MID database
+
+***********************************/
+
+// acq_2g.h - FFT code-phase acquisition of 2G bursts, carrier bins in parallel
+#ifndef ACQ_2G_H
+#define ACQ_2G_H
+
+// Coherent segment (chips), segments summed non-coherently, FFT size at
+// 2 samples per chip: every block tests 512 code phases (half-chip steps)
+#define ACQ2G_CHIPS 256
+#define ACQ2G_SEGMENTS 2
+#define ACQ2G_N 1024
+
+// Detection threshold on the mean segment power over the noise floor
+#define ACQ2G_SEUIL 12.0
+
+// ===================================================
+// Burst start found by the search
+// ===================================================
+typedef struct {
+    long long debut;    // Burst start, in samples at SGB_F_ECH
+    double phase_code;  // Code phase of the start within its block (chips)
+    double decalage;    // Carrier offset (Hz)
+    double metrique;    // Segment power over the noise floor
+} DetectionSGB;
+
+typedef struct Acq2G Acq2G;
+
+/**
+ * Create the search for the preamble of a PRN pair
+ * @param prn_i I spreading code, +1/-1, at least ACQ2G_SEGMENTS*ACQ2G_CHIPS chips
+ * @param prn_q Q spreading code, likewise
+ * @param decalage_max Carrier offsets searched on each side (Hz)
+ * @param n_fils Worker threads sharing the carrier bins, 0 for one per CPU
+ * @return New search, NULL on allocation error
+ */
+Acq2G *acq2g_cree(const signed char *prn_i, const signed char *prn_q,
+                  double decalage_max, int n_fils);
+
+/**
+ * Stop the workers and free the search
+ * @param a Search from acq2g_cree(), may be NULL
+ */
+void acq2g_detruit(Acq2G *a);
+
+/**
+ * Push one sample at SGB_F_ECH (4 samples per chip)
+ * @param a Search
+ * @param re Real part
+ * @param im Imaginary part
+ * @param det Set when a start is found
+ * @return 1 if det was set, 0 otherwise
+ */
+int acq2g_pousse(Acq2G *a, float re, float im, DetectionSGB *det);
+
+/**
+ * Describe the search on stdout
+ * @param a Search
+ */
+void acq2g_affiche(const Acq2G *a);
+
+#endif // ACQ_2G_H
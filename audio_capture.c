@@ -18,7 +18,13 @@
 #include <string.h>
 #include <time.h>
 #include <math.h>
+#include <stdint.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include "audio_capture.h"
+#include "audio_filter.h"
 #include "dec406.h"
 
 // Global variables from original
@@ -30,37 +36,257 @@ int longueur_trame = 144;
 int bits = 0;
 int N_canaux = 0;
 int opt_minute = 0;
+int opt_verbeux = 0;
 int canal_audio = 0;
 int n_ech = 0;
 char s[200];
-double Y[242];
 double coeff = 100;
+double niveau_max = NIVEAU_INITIAL;
+double banc[DEMOD_BANC_MAX - 1];
+double banc_niveau[DEMOD_BANC_MAX - 1];
+int n_banc = 0;
+int decimation = 1;
+int filtre_entree = 0;
+double f_passe_haut = PASSE_HAUT_DEFAUT;
+double f_passe_bas = PASSE_BAS_DEFAUT;
+int f_ech_raw = 0;
+int mode_continu = 0;
+int porte_energie = 1;
+int opt_horodatage = 0;
+double t_ancrage = -1.0;
+int format_iq = IQ_AUCUN;
+int f_iq = 0;
+double bande_iq = IQ_BANDE_DEFAUT;
+double f_centre_canaux = 0.0;
+int mode_sgb = 0;
 
-// Read sample function
-int lit_ech(FILE *fp) {
-    int echantillon = 0;
-    unsigned char ech8[10];
-    unsigned short ech16[10];
-    
-    if (bits == 8) {
-        if (N_canaux == 1) {
-            if (fread(ech8, 1, 1, fp) < 1) return 1000000;
-            echantillon = (ech8[0] - 128) * 256;
-        } else {
-            if (fread(ech8, 1, 2, fp) < 2) return 1000000;
-            echantillon = (ech8[canal_audio] - 128) * 256;
+// ===================================================
+// Block-buffered sample input
+// ===================================================
+// Samples are read in large blocks and converted to 16-bit mono in one
+// pass. Regular files use big blocks; pipes and terminals use small ones
+// so that real-time decoding from sox keeps a low latency. The current
+// span is handed out whole by lit_span() or sample by sample by lit_ech().
+#define BLOC_FICHIER 65536
+#define BLOC_FLUX 4096
+
+static unsigned char brut[BLOC_FICHIER];
+static short tampon[BLOC_FICHIER];
+static FILE *fp_tampon = NULL;
+static int n_tampon = 0;
+static int pos_tampon = 0;
+static int fin_tampon = 0;
+
+static void tampon_associe(FILE *fp) {
+    if (fp != fp_tampon) {
+        fp_tampon = fp;
+        n_tampon = 0;
+        pos_tampon = 0;
+        fin_tampon = 0;
+    }
+}
+
+// Convert n interleaved PCM frames to 16-bit samples of one channel
+static void convertit_pcm(const unsigned char *src, int n, short *ech,
+                          int bits_ech, int canaux) {
+    int octets = (bits_ech == 8) ? 1 : 2;
+    int taille_trame = octets * canaux;
+    int canal = (canal_audio < canaux) ? canal_audio : 0;
+    const unsigned char *p = src + canal * octets;
+    int i;
+
+    if (octets == 1) {
+        for (i = 0; i < n; i++, p += taille_trame) {
+            ech[i] = (p[0] - 128) * 256;
         }
     } else {
-        if (N_canaux == 1) {
-            if (fread(&ech16[0], 2, 1, fp) < 1) return 1000000;
-            echantillon = (short)ech16[0];
-        } else {
-            if (fread(&ech16[0], 2, 2, fp) < 2) return 1000000;
-            echantillon = (short)ech16[canal_audio];
+        for (i = 0; i < n; i++, p += taille_trame) {
+            ech[i] = (short)(p[0] | (p[1] << 8));
+        }
+    }
+}
+
+// Read a block of samples from file
+int lit_bloc(FILE *fp, short *ech, int max) {
+    struct stat st;
+    int taille_trame = ((bits == 8) ? 1 : 2) * N_canaux;
+    int taille_bloc = BLOC_FICHIER;
+    int n;
+
+    if (taille_trame <= 0) return 0;
+    if (fstat(fileno(fp), &st) == 0 && !S_ISREG(st.st_mode)) {
+        taille_bloc = BLOC_FLUX;
+    }
+    n = taille_bloc / taille_trame;
+    if (n > max) n = max;
+
+    n = fread(brut, taille_trame, n, fp);
+    convertit_pcm(brut, n, ech, bits, N_canaux);
+    return n;
+}
+
+// ===================================================
+// Memory-mapped WAV input
+// ===================================================
+// A mapped WAV file hands its data chunk to the decoder in place. 16-bit
+// mono PCM is read directly from the mapping; other layouts are converted
+// block by block from memory. A WavMappe holds no hidden state, so several
+// threads can read the same file or different files at once.
+
+static uint32_t lit_u32(const unsigned char *p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint16_t lit_u16(const unsigned char *p) {
+    return p[0] | (p[1] << 8);
+}
+
+// Walk the RIFF chunks of a mapped WAV file
+static int analyse_wav_map(WavMappe *w) {
+    const unsigned char *p = w->base;
+    size_t taille = w->taille;
+    size_t pos = 12;
+    int fmt_trouve = 0;
+
+    if (taille < 12 || memcmp(p, "RIFF", 4) != 0 || memcmp(p + 8, "WAVE", 4) != 0) {
+        return WAV_ERR_RIFF;
+    }
+
+    while (pos + 8 <= taille) {
+        const unsigned char *chunk = p + pos;
+        size_t longueur = lit_u32(chunk + 4);
+
+        if (memcmp(chunk, "fmt ", 4) == 0 && longueur >= 16 && pos + 24 <= taille) {
+            w->N_canaux = lit_u16(chunk + 10);
+            w->f_ech = lit_u32(chunk + 12);
+            w->bits = lit_u16(chunk + 22);
+            fmt_trouve = 1;
+        } else if (memcmp(chunk, "data", 4) == 0) {
+            int taille_trame = ((w->bits == 8) ? 1 : 2) * w->N_canaux;
+            if (!fmt_trouve || taille_trame <= 0) break;
+            // Streamed WAV files may carry a bogus data size
+            if (longueur > taille - pos - 8) longueur = taille - pos - 8;
+            w->pcm = chunk + 8;
+            w->n_trames = longueur / taille_trame;
+            return 0;
         }
+        pos += 8 + longueur + (longueur & 1);
+    }
+
+    return WAV_ERR_ENTETE;
+}
+
+int wav_mappe_ouvre(WavMappe *w, const char *chemin) {
+    struct stat st;
+    void *base;
+    int err;
+    int fd = open(chemin, O_RDONLY);
+
+    memset(w, 0, sizeof(*w));
+    if (fd < 0) return WAV_ERR_OUVERTURE;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0) {
+        close(fd);
+        return WAV_ERR_OUVERTURE;
     }
+
+    base = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return WAV_ERR_OUVERTURE;
+    madvise(base, st.st_size, MADV_SEQUENTIAL);
+
+    w->base = base;
+    w->taille = st.st_size;
+    err = analyse_wav_map(w);
+    if (err != 0) wav_mappe_ferme(w);
+    return err;
+}
+
+void wav_mappe_ferme(WavMappe *w) {
+    if (w->base) munmap(w->base, w->taille);
+    memset(w, 0, sizeof(*w));
+}
+
+int wav_mappe_lit(const WavMappe *w, size_t debut, int n, short *tampon_ech,
+                  const short **ech) {
+    int taille_trame = ((w->bits == 8) ? 1 : 2) * w->N_canaux;
+    const unsigned char *p = w->pcm + debut * taille_trame;
+
+    if (debut >= w->n_trames) return 0;
+    if ((size_t)n > w->n_trames - debut) n = (int)(w->n_trames - debut);
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    if (w->bits == 16 && w->N_canaux == 1 && ((uintptr_t)p & 1) == 0) {
+        *ech = (const short *)p;
+        return n;
+    }
+#endif
+    convertit_pcm(p, n, tampon_ech, w->bits, w->N_canaux);
+    *ech = tampon_ech;
+    return n;
+}
+
+// Map a WAV file for the single-file decoder and take its format
+int ouvre_wav_mmap(WavMappe *w, const char *chemin) {
+    int err = wav_mappe_ouvre(w, chemin);
+
+    if (err == WAV_ERR_RIFF) {
+        printf("Erreur, ce n'est pas un fichier RIFF/WAVE\n");
+    } else if (err == WAV_ERR_ENTETE) {
+        printf("Erreur lecture entete\n");
+    }
+    if (err != 0) return err;
+
+    N_canaux = w->N_canaux;
+    f_ech = w->f_ech;
+    bits = w->bits;
+    ech_par_bit = f_ech / bauds;
+    return 0;
+}
+
+// Make sure buffered samples are available, return 0 on EOF
+static int tampon_remplit(FILE *fp) {
+    int n;
+
+    tampon_associe(fp);
+    if (pos_tampon < n_tampon) return 1;
+    if (fin_tampon) return 0;
+
+    n = lit_bloc(fp, tampon, BLOC_FICHIER);
+    if (n == 0) {
+        n_tampon = 0;
+        pos_tampon = 0;
+        fin_tampon = 1;
+        return 0;
+    }
+
+    n_tampon = n;
+    pos_tampon = 0;
+    return 1;
+}
+
+// Take the rest of the buffered span
+int lit_span(FILE *fp, const short **ech) {
+    int n;
+
+    if (!tampon_remplit(fp)) return 0;
+    n = n_tampon - pos_tampon;
+    *ech = tampon + pos_tampon;
+    pos_tampon = n_tampon;
+    n_ech += n;
+    return n;
+}
+
+// Read sample function
+int lit_ech(FILE *fp) {
+    if (!tampon_remplit(fp)) return 1000000;
     n_ech++;
-    return echantillon;
+    return tampon[pos_tampon++];
+}
+
+// End of stream reached and all buffered samples consumed
+int fin_flux_audio(FILE *fp) {
+    tampon_associe(fp);
+    return fin_tampon && pos_tampon >= n_tampon;
 }
 
 // Read WAV header
@@ -106,171 +332,120 @@ int lit_entete_wav(FILE *fp) {
     return 0;
 }
 
+// Decoder configuration from the command-line settings
+void demod_config_audio(DemodConfig *cfg) {
+    demod_config_defaut(cfg, f_ech);
+    cfg->bauds = bauds;
+    cfg->coeff = coeff;
+    cfg->niveau = niveau_max;
+    memcpy(cfg->banc, banc, sizeof(banc));
+    memcpy(cfg->banc_niveau, banc_niveau, sizeof(banc_niveau));
+    cfg->n_banc = n_banc;
+    cfg->decimation = decimation;
+    cfg->filtre = filtre_entree;
+    cfg->f_passe_haut = f_passe_haut;
+    cfg->f_passe_bas = f_passe_bas;
+    cfg->verbeux = 1;
+    cfg->continu = mode_continu;
+    cfg->porte = porte_energie;
+}
+
+// ===================================================
+// Single-frame capture on the default decoder
+// ===================================================
+static Demod1G *demod_defaut = NULL;
+static FILE *fp_demod = NULL;
+static int trame_prise = 0;
+
+static void capture_cb(const TrameDemod *trame, void *utilisateur) {
+    int i;
+
+    (void)utilisateur;
+    longueur_trame = trame->bits.longueur;
+    for (i = 0; i < trame->bits.longueur; i++) {
+        s[i] = trame406_bit(&trame->bits, i) ? '1' : '0';
+    }
+    affiche_horodatage(trame->ech_sync, trame->t_sync, f_ech);
+    decode_1g_soft(&trame->bits, trame->fiabilite);
+    trame_prise = 1;
+}
+
 // Main capture loop
 int capture_trame(FILE *fp) {
-    int Nb = ech_par_bit;
-    int depart = 0;
-    int echantillon;
-    int numBit = 0;
-    char etat = '-';
-    int cpte = 0;
-    int synchro = 0;
-    double Y1 = 0.0;
-    double Ymoy = 0.0;
-    double Max = 10e3;
-    double Min = -Max;
-    double max = Max;
-    double min = Min;
-    double seuil0 = Min / coeff;
-    double seuil1 = Max / coeff;
-    int i, j, k, l;
-    int Nb15;
-    clock_t t1, t2;
-    double dt;
-    double clk_tck = CLOCKS_PER_SEC;
-    
-    k = 0;
-    etat = '-';
-    numBit = 0;
-    synchro = 0;
-    depart = 0;
-    longueur_trame = 144;
-    
-    for (i = 0; i < 145; i++) {
-        s[i] = '-';
-    }
-    for (i = 0; i < 242; i++) {
-        Y[i] = 0.0;
+    DemodConfig cfg;
+    const short *ech;
+    int n;
+    long long t1;
+
+    if (!demod_defaut || fp != fp_demod) {
+        demod_detruit(demod_defaut);
+        demod_config_audio(&cfg);
+        demod_defaut = demod_cree(&cfg, capture_cb, NULL);
+        fp_demod = fp;
+        if (!demod_defaut) {
+            // Nothing can be decoded from this stream
+            tampon_associe(fp);
+            fin_tampon = 1;
+            pos_tampon = n_tampon;
+            return 0;
+        }
     }
+    ech_par_bit = f_ech / decim_facteur(f_ech, bauds, decimation) / bauds;
+    trame_prise = 0;
     
-    k = 0;
-    l = 0;
-    t1 = clock();
+    // Timeout on the sample clock: a quiet pipe uses no CPU time
+    t1 = demod_position(demod_defaut);
     
-    while (numBit < longueur_trame) {
-        
-        if (opt_minute == 1) {
-            t2 = clock();
-            dt = ((double)(t2 - t1)) / clk_tck;
-            if (dt > 55.0) {
-                fprintf(stderr, "Plus de 55s\n");
-                return 0;
-            }
-        }
+    while (!trame_prise) {
         
-        echantillon = lit_ech(fp);
-        if (echantillon == 1000000) {
-            fprintf(stderr, "Fin de lecture wav\n");
+        if (opt_minute == 1 &&
+            demod_position(demod_defaut) - t1 > (long long)TIMEOUT_MINUTE_S * f_ech) {
+            fprintf(stderr, "Plus de 55s\n");
             return 0;
         }
         
-        l++;
-        k = (k + 1) % (2 * Nb);
-        Y[k] = echantillon;
-        
-        Y1 = 0.0;
-        Ymoy = 0.0;
-        for (i = 0; i < 2 * Nb; i++) {
-            Ymoy = Ymoy + Y[i];
-        }
-        Ymoy = Ymoy / (2 * Nb);
-        
-        for (i = 0; i < Nb; i++) {
-            j = (k + i + Nb) % (2 * Nb);
-            Y1 = Y1 + (Y[(k + i) % (2 * Nb)] - Ymoy) * (Y[j] - Ymoy);
-        }
-        
-        if (Y1 > max) {
-            max = Y1;
-            seuil1 = max / coeff;
-        }
-        if (Y1 < min) {
-            min = Y1;
-            seuil0 = min / coeff;
-        }
-        
-        if (synchro == 0) {
-            if (depart == 0) {
-                if (Y1 > seuil1) {
-                    depart = 1;
-                }
-                cpte = 0;
-            } else {
-                cpte++;
-                if (Y1 < seuil0) {
-                    Nb15 = cpte / Nb;
-                    if ((Nb15 < 16) && (Nb15 > 11)) {
-                        synchro = 1;
-                        cpte = 0;
-                        for (i = 0; i < 15; i++) {
-                            s[i] = '1';
-                            numBit = 15;
-                            etat = '0';
-                        }
-                        printf("Sync found: %d ones\n", Nb15);
-                    } else {
-                        cpte = 0;
-                        depart = 0;
-                        synchro = 0;
-                        etat = '-';
-                        numBit = 0;
-                    }
-                }
-            }
-        } else {
-            cpte++;
-            
-            if (s[24] == '0') {
-                longueur_trame = 112;
-            }
-            
-            if (Y1 > seuil1) {
-                if (etat == '0') {
-                    etat = '1';
-                    cpte -= Nb / 2;
-                    while ((cpte > 0) && (numBit < longueur_trame)) {
-                        if (s[numBit - 1] == '1') {
-                            s[numBit] = '0';
-                        } else {
-                            s[numBit] = '1';
-                        }
-                        numBit++;
-                        cpte -= Nb;
-                    }
-                    cpte = 0;
-                }
-            } else {
-                if (Y1 < seuil0) {
-                    if (etat == '1') {
-                        etat = '0';
-                        cpte -= Nb / 2;
-                        while ((cpte > 0) && (numBit < 149)) {
-                            s[numBit] = s[numBit - 1];
-                            numBit++;
-                            cpte -= Nb;
-                        }
-                        cpte = 0;
-                    }
-                }
-            }
+        n = lit_span(fp, &ech);
+        if (n == 0) {
+            fprintf(stderr, "Fin de lecture wav\n");
+            // A frame the threshold bank still holds is the last one
+            demod_vide(demod_defaut);
+            return trame_prise ? longueur_trame : 0;
         }
+        demod_alimente(demod_defaut, ech, n);
     }
     
-    if (numBit >= longueur_trame) {
-        printf("%s frame captured (%d bits)\n", 
-               longueur_trame == 112 ? "Short" : "Long", longueur_trame);
-        
-        uint8_t bits_array[256];
-        for (int i = 0; i < longueur_trame; i++) {
-            bits_array[i] = (s[i] == '1') ? 1 : 0;
-        }
-        
-        decode_1g(bits_array, longueur_trame);
-        
-        return longueur_trame;
+    return longueur_trame;
+}
+
+// ===================================================
+// Sample clock
+// ===================================================
+void ancre_horloge(void) {
+    struct timespec ts;
+
+    if (!opt_horodatage || t_ancrage >= 0.0) return;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    t_ancrage = ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+void affiche_horodatage(long long ech, double t_ech, int f_ech_flux) {
+    double t;
+    time_t sec;
+    struct tm tm;
+
+    if (!opt_horodatage || f_ech_flux <= 0) return;
+    t = t_ech / f_ech_flux;
+    if (t_ancrage < 0.0) {
+        printf("Sync at t=%.6f s (sample %lld)\n", t, ech);
+        return;
     }
-    
-    return 0;
+    t += t_ancrage;
+    sec = (time_t)t;
+    gmtime_r(&sec, &tm);
+    printf("Sync at %04d-%02d-%02d %02d:%02d:%02d.%06d UTC (t=%.6f s, sample %lld)\n",
+           tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday,
+           tm.tm_hour, tm.tm_min, tm.tm_sec, (int)((t - sec) * 1e6),
+           t - t_ancrage, ech);
 }
 
 // Initialize audio capture parameters
@@ -282,12 +457,66 @@ void init_audio_capture(void) {
     bits = 0;
     N_canaux = 0;
     opt_minute = 0;
+    opt_verbeux = 0;
     canal_audio = 0;
     n_ech = 0;
     coeff = 100;
+    niveau_max = NIVEAU_INITIAL;
+    n_banc = 0;
+    decimation = 1;
+    filtre_entree = 0;
+    f_passe_haut = PASSE_HAUT_DEFAUT;
+    f_passe_bas = PASSE_BAS_DEFAUT;
+    f_ech_raw = 0;
+    mode_continu = 0;
+    porte_energie = 1;
+    opt_horodatage = 0;
+    t_ancrage = -1.0;
+    format_iq = IQ_AUCUN;
+    f_iq = 0;
+    bande_iq = IQ_BANDE_DEFAUT;
+    f_centre_canaux = 0.0;
+    mode_sgb = 0;
     
     memset(s, 0, sizeof(s));
-    memset(Y, 0, sizeof(Y));
+}
+
+// Threshold bank from "coeff[:M],...": coefficients 2 to 100, each with
+// its own max level 10^M if given
+static int lit_banc(const char *liste) {
+    const char *p = liste;
+    char *fin;
+
+    n_banc = 0;
+    while (*p) {
+        double c = strtod(p, &fin);
+        double v = 0.0;
+        if (fin == p || c < 2 || c > 100 || n_banc == DEMOD_BANC_MAX - 1) return 1;
+        p = fin;
+        if (*p == ':') {
+            int m = (int)strtol(p + 1, &fin, 10);
+            if (fin == p + 1 || m < 1 || m > 10) return 1;
+            v = pow(10.0, m);
+            p = fin;
+        }
+        banc[n_banc] = c;
+        banc_niveau[n_banc] = v;
+        n_banc++;
+        if (*p == ',') p++;
+        else if (*p) return 1;
+    }
+    return 0;
+}
+
+// Filter corner in Hz, strictly positive. The upper bound depends on the
+// output rate and is checked by filtre_init.
+static int lit_coin(const char *texte, double *f) {
+    char *fin;
+    double v = strtod(texte, &fin);
+
+    if (fin == texte || *fin != '\0' || !(v > 0.0)) return 1;
+    *f = v;
+    return 0;
 }
 
 // Process command line options for audio capture
@@ -299,6 +528,105 @@ void process_audio_options(int argc, char *argv[]) {
             opt_minute = 1;
             printf("55-second timeout enabled\n");
         }
+        else if (strcmp(argv[i], "--verbose") == 0) {
+            opt_verbeux = 1;
+        }
+        else if (strcmp(argv[i], "--decim") == 0) {
+            decimation = 0;
+            printf("Automatic decimation enabled\n");
+        }
+        else if (strncmp(argv[i], "--decim=", 8) == 0) {
+            int val = atoi(argv[i] + 8);
+            if (val >= 1) {
+                decimation = val;
+                printf("Decimation ratio set to %d\n", decimation);
+            }
+        }
+        else if (strcmp(argv[i], "--filtre") == 0) {
+            filtre_entree = 1;
+        }
+        else if (strncmp(argv[i], "--passe_haut=", 13) == 0) {
+            if (lit_coin(argv[i] + 13, &f_passe_haut) != 0) {
+                fprintf(stderr, "Invalid high-pass corner: %s\n", argv[i] + 13);
+            } else {
+                filtre_entree = 1;
+                printf("High-pass corner set to %.0f Hz\n", f_passe_haut);
+            }
+        }
+        else if (strncmp(argv[i], "--passe_bas=", 12) == 0) {
+            if (lit_coin(argv[i] + 12, &f_passe_bas) != 0) {
+                fprintf(stderr, "Invalid low-pass corner: %s\n", argv[i] + 12);
+            } else {
+                filtre_entree = 1;
+                printf("Low-pass corner set to %.0f Hz\n", f_passe_bas);
+            }
+        }
+        else if (strncmp(argv[i], "--raw=", 6) == 0) {
+            f_ech_raw = atoi(argv[i] + 6);
+            printf("Raw 16-bit mono input at %d Hz\n", f_ech_raw);
+        }
+        else if (strcmp(argv[i], "--continu") == 0) {
+            mode_continu = 1;
+            printf("Continuous demodulation (state kept across frames)\n");
+        }
+        else if (strcmp(argv[i], "--sans_porte") == 0) {
+            porte_energie = 0;
+            printf("Energy gate off (correlator on every sample)\n");
+        }
+        else if (strcmp(argv[i], "--horodatage") == 0) {
+            opt_horodatage = 1;
+            printf("Sync timestamps from the sample clock\n");
+        }
+        else if (strncmp(argv[i], "--horodatage=", 13) == 0) {
+            opt_horodatage = 1;
+            t_ancrage = atof(argv[i] + 13);
+            printf("Sync timestamps anchored at %.3f s UTC\n", t_ancrage);
+        }
+        else if (strncmp(argv[i], "--iq=", 5) == 0) {
+            format_iq = iq_format(argv[i] + 5);
+            if (format_iq == IQ_AUCUN) {
+                fprintf(stderr, "Unknown IQ format: %s (cu8, cs8, cs16, cf32)\n", argv[i] + 5);
+            } else {
+                printf("IQ input: %s\n", argv[i] + 5);
+            }
+        }
+        else if (strncmp(argv[i], "--f_iq=", 7) == 0) {
+            f_iq = atoi(argv[i] + 7);
+            printf("IQ sample rate set to %d Hz\n", f_iq);
+        }
+        else if (strncmp(argv[i], "--iq_bande=", 11) == 0) {
+            bande_iq = atof(argv[i] + 11);
+            printf("IQ channel filter set to +/-%.0f Hz\n", bande_iq);
+        }
+        else if (strncmp(argv[i], "--canaux=", 9) == 0) {
+            f_centre_canaux = atof(argv[i] + 9);
+            printf("All channels around %.6f MHz\n", f_centre_canaux / 1e6);
+        }
+        else if (strcmp(argv[i], "--sgb") == 0) {
+            mode_sgb = 1;
+            printf("2G (T.018) burst receiver\n");
+        }
+        else if (strcmp(argv[i], "--sgb=fft") == 0) {
+            mode_sgb = 2;
+            printf("2G (T.018) burst receiver, FFT acquisition\n");
+        }
+        else if (strcmp(argv[i], "--banc") == 0) {
+            static const double defaut[] = { 100, 50, 20, 10, 5, 2 };
+            for (n_banc = 0; n_banc < (int)(sizeof(defaut) / sizeof(defaut[0])); n_banc++) {
+                banc[n_banc] = defaut[n_banc];
+                banc_niveau[n_banc] = 0.0;
+            }
+            printf("Threshold bank: coefficients 100, 50, 20, 10, 5, 2\n");
+        }
+        else if (strncmp(argv[i], "--banc=", 7) == 0) {
+            if (lit_banc(argv[i] + 7) != 0) {
+                fprintf(stderr, "Invalid threshold bank: %s (coeff[:M],... at most %d)\n",
+                        argv[i] + 7, DEMOD_BANC_MAX - 1);
+                n_banc = 0;
+            } else {
+                printf("Threshold bank: %d coefficient(s)\n", n_banc);
+            }
+        }
         else if (strcmp(argv[i], "--canal1") == 0) {
             canal_audio = 1;
             printf("Using audio channel 1 (right)\n");
@@ -314,10 +642,22 @@ void process_audio_options(int argc, char *argv[]) {
                 // Max level setting
                 val = atoi(argv[i] + 3);
                 if (val >= 1 && val <= 10) {
-                    // This would modify Max/Min in capture_trame
+                    niveau_max = pow(10.0, val);
                     printf("Max level set to 10^%d\n", val);
                 }
             }
         }
     }
+
+    // Corners may come in any order, check them as a pair once all are read
+    if (filtre_entree && f_passe_haut >= f_passe_bas) {
+        fprintf(stderr, "High-pass corner %.0f Hz not below low-pass corner %.0f Hz, "
+                "using %.0f-%.0f Hz\n", f_passe_haut, f_passe_bas,
+                PASSE_HAUT_DEFAUT, PASSE_BAS_DEFAUT);
+        f_passe_haut = PASSE_HAUT_DEFAUT;
+        f_passe_bas = PASSE_BAS_DEFAUT;
+    }
+    if (filtre_entree) {
+        printf("Input filter enabled (%.0f-%.0f Hz)\n", f_passe_haut, f_passe_bas);
+    }
 }
@@ -17,12 +17,16 @@
 #define AUDIO_CAPTURE_H
 
 #include <stdio.h>
+#include <stddef.h>
+#include "demod_1g.h"
+#include "iq_demod.h"
 
 // ===================================================
 // Constants
 // ===================================================
 #define SEUIL 2000
 #define MAX_FRAME_BITS 200
+#define TIMEOUT_MINUTE_S 55   // --une_minute timeout on the sample clock (s)
 
 // ===================================================
 // Global variables (exposed for configuration)
@@ -34,11 +38,29 @@ extern int longueur_trame; // Frame length
 extern int bits;           // Bits per sample (8 or 16)
 extern int N_canaux;       // Number of channels
 extern int opt_minute;     // 55-second timeout option
+extern int opt_verbeux;    // Statistics on stderr (--verbose)
 extern int canal_audio;    // Audio channel to use (0 or 1)
 extern int n_ech;          // Sample counter
 extern char s[200];        // Decoded bit string
-extern double Y[242];      // Correlation values
 extern double coeff;       // Threshold coefficient
+extern double niveau_max;  // Starting level of the correlator peaks (--M)
+extern double banc[DEMOD_BANC_MAX - 1];        // More coefficients (--banc)
+extern double banc_niveau[DEMOD_BANC_MAX - 1]; // Their level, 0 for niveau_max
+extern int n_banc;         // Number of them
+extern int decimation;     // Decimation ratio (1 = off, 0 = auto)
+extern int filtre_entree;  // Built-in front end (DC blocker, FIR, band-pass)
+extern double f_passe_haut; // Front end high-pass corner (Hz)
+extern double f_passe_bas;  // Front end low-pass corner (Hz)
+extern int f_ech_raw;      // Sample rate of headerless input (0 = WAV header)
+extern int mode_continu;   // Keep demodulator state across frames
+extern int porte_energie;  // Skip the correlator between bursts
+extern int opt_horodatage; // Print a timestamp for each sync
+extern double t_ancrage;   // UTC time of sample 0 (s), negative if not anchored
+extern int format_iq;      // FormatIQ of raw IQ input (IQ_AUCUN = audio)
+extern int f_iq;           // IQ sample rate (Hz)
+extern double bande_iq;    // IQ channel filter half-width (Hz)
+extern double f_centre_canaux;    // Tuner centre for all-channel IQ decoding (Hz, 0 = off)
+extern int mode_sgb;       // Decode 2G (T.018) bursts from the IQ input (2 = FFT search)
 
 // ===================================================
 // Main functions
@@ -52,19 +74,121 @@ extern double coeff;       // Threshold coefficient
 int lit_entete_wav(FILE *fp);
 
 /**
- * Read one audio sample from file
+ * Read a block of audio samples from file
+ * Converts 8/16-bit PCM to 16-bit samples of channel canal_audio in one pass
+ * @param fp File pointer to audio stream
+ * @param ech Output sample array
+ * @param max Capacity of ech
+ * @return Number of samples read, 0 on EOF
+ */
+int lit_bloc(FILE *fp, short *ech, int max);
+
+// ===================================================
+// Memory-mapped WAV files
+// ===================================================
+#define WAV_ERR_OUVERTURE 1  // Cannot open or map the file
+#define WAV_ERR_RIFF      2  // Not a RIFF/WAVE file
+#define WAV_ERR_ENTETE    3  // Missing or invalid fmt/data chunk
+
+typedef struct {
+    unsigned char *base;        // Mapping of the whole file
+    size_t taille;              // File size
+    const unsigned char *pcm;   // Start of the data chunk
+    size_t n_trames;            // PCM frames in the data chunk
+    int f_ech;                  // Sample rate
+    int bits;                   // Bits per sample (8 or 16)
+    int N_canaux;               // Number of channels
+} WavMappe;
+
+/**
+ * Map a WAV file and parse its header (reentrant)
+ * @param w Mapping to fill
+ * @param chemin Path to WAV file
+ * @return 0 on success, WAV_ERR_* otherwise
+ */
+int wav_mappe_ouvre(WavMappe *w, const char *chemin);
+
+/**
+ * Unmap a file opened with wav_mappe_ouvre()
+ * @param w Mapping
+ */
+void wav_mappe_ferme(WavMappe *w);
+
+/**
+ * Get samples of channel canal_audio from a mapped file (reentrant)
+ * 16-bit mono data is returned in place, other formats are converted
+ * @param w Mapping
+ * @param debut First PCM frame
+ * @param n Number of frames wanted
+ * @param tampon_ech Conversion buffer of at least n samples
+ * @param ech Set to the first sample
+ * @return Number of samples, 0 past the end of data
+ */
+int wav_mappe_lit(const WavMappe *w, size_t debut, int n, short *tampon_ech,
+                  const short **ech);
+
+/**
+ * Map a WAV file for the single-file decoder
+ * Parses the header, reports errors and sets f_ech, bits and N_canaux
+ * @param w Mapping to fill, released by the caller with wav_mappe_ferme()
+ * @param chemin Path to WAV file
+ * @return 0 on success, WAV_ERR_* otherwise
+ */
+int ouvre_wav_mmap(WavMappe *w, const char *chemin);
+
+/**
+ * Take the buffered samples of a stream, reading a new block if needed
+ * The span stays valid until the next read on the same stream
+ * @param fp File pointer to audio stream
+ * @param ech Set to the first sample of the span
+ * @return Number of samples, 0 on EOF
+ */
+int lit_span(FILE *fp, const short **ech);
+
+/**
+ * Read one audio sample from the block buffer
  * @param fp File pointer to audio stream
  * @return Sample value or 1000000 on EOF
  */
 int lit_ech(FILE *fp);
 
 /**
- * Capture and decode a complete frame
+ * Check for end of audio stream
+ * @param fp File pointer to audio stream
+ * @return 1 once EOF is reached and all buffered samples are consumed
+ */
+int fin_flux_audio(FILE *fp);
+
+/**
+ * Build a decoder configuration from the command-line settings
+ * @param cfg Configuration to fill
+ */
+void demod_config_audio(DemodConfig *cfg);
+
+/**
+ * Capture and decode frames until at least one is found
+ * Uses a default decoder kept across calls on the same stream; every
+ * frame in the block that completes the first one is decoded too
  * @param fp File pointer to audio stream
- * @return 1 if frame decoded successfully, 0 otherwise
+ * @return Length of the last frame decoded, 0 on EOF or timeout
  */
 int capture_trame(FILE *fp);
 
+/**
+ * Anchor the sample clock to the current UTC time
+ * Does nothing without --horodatage or if already anchored
+ */
+void ancre_horloge(void);
+
+/**
+ * Print the time of a sync from its sample index
+ * Relative to the stream start, or UTC once the clock is anchored
+ * @param ech Input sample index
+ * @param t_ech Same, with the sub-sample part used for the time
+ * @param f_ech_flux Input sample rate (Hz)
+ */
+void affiche_horodatage(long long ech, double t_ech, int f_ech_flux);
+
 /**
  * Process command line options for audio capture
  * @param argc Argument count
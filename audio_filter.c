@@ -0,0 +1,188 @@
+/**********************************
+
+## Licence
+
+ Licence Creative Commons CC BY-NC-SA 
+
+## Auteurs et contributions
+
+- **Code original dec406_v7** : F4EHY (2020)
+- **Refactoring et support 2G** : Développement collaboratif (2025)
+- **Conformité T.018** : Implémentation complète BCH + MID database
+
+***********************************/
+
+// audio_filter.c - Audio front end ahead of the correlator
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "audio_filter.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// ===================================================
+// Integer-ratio decimator
+// ===================================================
+void decim_init(Decimateur *d, int facteur) {
+    d->facteur = (facteur < 1) ? 1 : facteur;
+    d->phase = 0;
+    d->somme = 0;
+}
+
+int decim_bloc(Decimateur *d, const short *in, int n, short *out) {
+    int i, m = 0;
+
+    if (d->facteur <= 1) {
+        if (out != in) memmove(out, in, n * sizeof(short));
+        return n;
+    }
+    for (i = 0; i < n; i++) {
+        d->somme += in[i];
+        if (++d->phase == d->facteur) {
+            out[m++] = (short)(d->somme / d->facteur);
+            d->phase = 0;
+            d->somme = 0;
+        }
+    }
+    return m;
+}
+
+int decim_facteur(int f_ech, int bauds, int demande) {
+    int facteur;
+
+    if (demande >= 1) return demande;
+    if (f_ech <= 0 || bauds <= 0) return 1;
+
+    // Automatic: largest ratio keeping enough samples per bit
+    facteur = f_ech / (bauds * ECH_PAR_BIT_CIBLE);
+    return (facteur < 1) ? 1 : facteur;
+}
+
+// ===================================================
+// Biquads (RBJ cookbook, Butterworth Q)
+// ===================================================
+static void biquad_init(Biquad *b, double fc, double fs, int passe_haut) {
+    double w0 = 2.0 * M_PI * fc / fs;
+    double alpha = sin(w0) / (2.0 * M_SQRT1_2);
+    double c = cos(w0);
+    double a0 = 1.0 + alpha;
+
+    if (passe_haut) {
+        b->b0 = (1.0 + c) / 2.0 / a0;
+        b->b1 = -(1.0 + c) / a0;
+    } else {
+        b->b0 = (1.0 - c) / 2.0 / a0;
+        b->b1 = (1.0 - c) / a0;
+    }
+    b->b2 = b->b0;
+    b->a1 = -2.0 * c / a0;
+    b->a2 = (1.0 - alpha) / a0;
+    b->z1 = 0.0;
+    b->z2 = 0.0;
+}
+
+static inline double biquad_ech(Biquad *b, double x) {
+    double y = b->b0 * x + b->z1;
+    b->z1 = b->b1 * x - b->a1 * y + b->z2;
+    b->z2 = b->b2 * x - b->a2 * y;
+    return y;
+}
+
+// ===================================================
+// Front end
+// ===================================================
+int filtre_init(FiltreEntree *f, int f_ech, int facteur, double f_haut, double f_bas) {
+    int i;
+
+    filtre_libere(f);
+    f->facteur = (facteur < 1) ? 1 : facteur;
+    f->f_sortie = (double)f_ech / f->facteur;
+    if (f_haut <= 0.0 || f_haut >= f_bas || f_haut >= f->f_sortie / 2.0 ||
+        f_bas >= f->f_sortie / 2.0) {
+        return FILTRE_ERR_COINS;
+    }
+
+    // DC blocker pole well below the high-pass corner
+    f->dc_r = 1.0 - 2.0 * M_PI * 1.0 / f_ech;
+    f->dc_x1 = 0.0;
+    f->dc_y1 = 0.0;
+
+    // Blackman-windowed sinc, cutoff at 0.8 x output Nyquist
+    f->ntaps = (f->facteur > 1) ? TAPS_PAR_FACTEUR * f->facteur + 1 : 1;
+    f->h = malloc(f->ntaps * sizeof(double));
+    f->hist = calloc(2 * f->ntaps, sizeof(double));
+    if (!f->h || !f->hist) {
+        filtre_libere(f);
+        return FILTRE_ERR_MEMOIRE;
+    }
+    if (f->ntaps == 1) {
+        f->h[0] = 1.0;
+    } else {
+        double fc = 0.4 / f->facteur;
+        double somme = 0.0;
+        int m = f->ntaps - 1;
+        for (i = 0; i < f->ntaps; i++) {
+            double t = i - m / 2.0;
+            double sinc = (t == 0.0) ? 2.0 * fc : sin(2.0 * M_PI * fc * t) / (M_PI * t);
+            double w = 0.42 - 0.5 * cos(2.0 * M_PI * i / m) + 0.08 * cos(4.0 * M_PI * i / m);
+            f->h[i] = sinc * w;
+            somme += f->h[i];
+        }
+        for (i = 0; i < f->ntaps; i++) f->h[i] /= somme;
+    }
+    f->pos = 0;
+    f->phase = 0;
+
+    biquad_init(&f->passe_haut, f_haut, f->f_sortie, 1);
+    f->passe_bas_actif = (f_bas < 0.45 * f->f_sortie);
+    if (f->passe_bas_actif) {
+        biquad_init(&f->passe_bas, f_bas, f->f_sortie, 0);
+    }
+    return 0;
+}
+
+void filtre_libere(FiltreEntree *f) {
+    free(f->h);
+    free(f->hist);
+    f->h = NULL;
+    f->hist = NULL;
+    f->ntaps = 0;
+}
+
+int filtre_bloc(FiltreEntree *f, const short *in, int n, short *out) {
+    int i, j, m = 0;
+
+    for (i = 0; i < n; i++) {
+        // DC blocker
+        double x = in[i];
+        double y = x - f->dc_x1 + f->dc_r * f->dc_y1;
+        f->dc_x1 = x;
+        f->dc_y1 = y;
+
+        // Anti-alias FIR, evaluated once per output sample
+        f->hist[f->pos] = y;
+        f->hist[f->pos + f->ntaps] = y;
+        if (++f->pos == f->ntaps) f->pos = 0;
+        if (++f->phase < f->facteur) continue;
+        f->phase = 0;
+
+        {
+            const double *x0 = f->hist + f->pos;
+            double acc = 0.0;
+            for (j = 0; j < f->ntaps; j++) acc += f->h[j] * x0[j];
+            y = acc;
+        }
+
+        // Band-pass at the output rate
+        y = biquad_ech(&f->passe_haut, y);
+        if (f->passe_bas_actif) y = biquad_ech(&f->passe_bas, y);
+
+        y = floor(y + 0.5);
+        if (y > 32767.0) y = 32767.0;
+        if (y < -32768.0) y = -32768.0;
+        out[m++] = (short)y;
+    }
+    return m;
+}
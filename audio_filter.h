@@ -0,0 +1,124 @@
+/**********************************
+
+## Licence
+
+ Licence Creative Commons CC BY-NC-SA 
+
+## Auteurs et contributions
+
+- **Code original dec406_v7** : F4EHY (2020)
+- **Refactoring et support 2G** : Développement collaboratif (2025)
+- **Conformité T.018** : Implémentation complète BCH + MID database
+
+***********************************/
+
+// audio_filter.h - Audio front end ahead of the correlator
+#ifndef AUDIO_FILTER_H
+#define AUDIO_FILTER_H
+
+// Samples per bit aimed at by automatic decimation
+#define ECH_PAR_BIT_CIBLE 50
+
+// Default band-pass corners (same as the former sox filter chain)
+#define PASSE_HAUT_DEFAUT 10.0
+#define PASSE_BAS_DEFAUT 3000.0
+
+// FIR taps per unit of decimation ratio
+#define TAPS_PAR_FACTEUR 8
+
+// filtre_init errors
+#define FILTRE_ERR_MEMOIRE 1  // Allocation failed
+#define FILTRE_ERR_COINS   2  // Corners not within 0 < f_haut < f_bas < f_sortie/2
+
+// ===================================================
+// Integer-ratio decimator (integrate and dump)
+// ===================================================
+typedef struct {
+    int facteur;    // Decimation ratio (1 = pass-through)
+    int phase;      // Samples accumulated so far
+    long somme;     // Running sum of the current group
+} Decimateur;
+
+// ===================================================
+// Second-order IIR section
+// ===================================================
+typedef struct {
+    double b0, b1, b2, a1, a2;
+    double z1, z2;
+} Biquad;
+
+// ===================================================
+// Front end: DC blocker, decimating FIR, band-pass
+// ===================================================
+typedef struct {
+    int facteur;        // Decimation ratio
+    double f_sortie;    // Output sample rate
+    // DC blocker
+    double dc_r;
+    double dc_x1, dc_y1;
+    // Polyphase decimating FIR (only kept outputs are computed)
+    double *h;
+    double *hist;       // History, stored twice for contiguous reads
+    int ntaps;
+    int pos;
+    int phase;
+    // Band-pass at the output rate
+    Biquad passe_haut;
+    Biquad passe_bas;
+    int passe_bas_actif;
+} FiltreEntree;
+
+/**
+ * Initialize a decimator
+ * @param d Decimator state
+ * @param facteur Integer decimation ratio (>= 1)
+ */
+void decim_init(Decimateur *d, int facteur);
+
+/**
+ * Decimate a block of samples
+ * @param d Decimator state
+ * @param in Input samples
+ * @param n Number of input samples
+ * @param out Output samples (may alias in)
+ * @return Number of output samples
+ */
+int decim_bloc(Decimateur *d, const short *in, int n, short *out);
+
+/**
+ * Choose a decimation ratio for a sample rate
+ * @param f_ech Input sample rate
+ * @param bauds Bit rate
+ * @param demande Requested ratio, 0 for automatic
+ * @return Ratio keeping at least ECH_PAR_BIT_CIBLE samples per bit in auto mode
+ */
+int decim_facteur(int f_ech, int bauds, int demande);
+
+/**
+ * Configure the front end
+ * @param f Front end state
+ * @param f_ech Input sample rate
+ * @param facteur Decimation ratio
+ * @param f_haut High-pass corner frequency (Hz)
+ * @param f_bas Low-pass corner frequency (Hz)
+ * @return 0 on success, FILTRE_ERR_* otherwise
+ */
+int filtre_init(FiltreEntree *f, int f_ech, int facteur, double f_haut, double f_bas);
+
+/**
+ * Release front end buffers
+ * @param f Front end state
+ */
+void filtre_libere(FiltreEntree *f);
+
+/**
+ * Filter and decimate a block of samples
+ * @param f Front end state
+ * @param in Input samples
+ * @param n Number of input samples
+ * @param out Output samples (may alias in)
+ * @return Number of output samples
+ */
+int filtre_bloc(FiltreEntree *f, const short *in, int n, short *out);
+
+#endif // AUDIO_FILTER_H
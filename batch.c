@@ -0,0 +1,585 @@
+/**********************************
+
+## Licence
+
+ Licence Creative Commons CC BY-NC-SA 
+
+## Auteurs et contributions
+
+- **Code original dec406_v7** : F4EHY (2020)
+- **Refactoring et support 2G** : Développement collaboratif (2025)
+- **Conformité T.018** : Implémentation complète BCH + MID database
+
+***********************************/
+
+// batch.c - Parallel decoding of many WAV recordings or of one long one
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <pthread.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "batch.h"
+#include "audio_capture.h"
+#include "audio_filter.h"
+#include "demod_1g.h"
+#include "demod_kernels.h"
+#include "dec406.h"
+
+#define BLOC_LOT 65536
+
+// ===================================================
+// Tasks: a whole file or a segment of a mapped file
+// ===================================================
+typedef struct {
+    const char *chemin;
+    const WavMappe *wav;    // Shared mapping for segments, NULL to map chemin
+    size_t debut;           // First PCM frame demodulated
+    size_t propre;          // Frames synced earlier belong to the previous task
+    size_t fin;             // End of the task, 0 for end of file
+    TrameDemod *trames;     // Frames in time order, positions from file start
+    int n_trames;
+    int capacite;
+    long long n_ech;        // Samples demodulated
+    int f_ech;              // Sample rate of the file
+    int erreur;             // WAV_ERR_* or -1 if the decoder failed
+    int fini;
+} Tache;
+
+// ===================================================
+// Work-stealing queues
+// ===================================================
+// Each worker owns a queue of file indices, dealt round-robin so that
+// files finish roughly in input order. The owner takes from the front;
+// an idle worker steals from the back of another queue. No task is ever
+// added once the pool runs, so all queues empty means the work is done.
+typedef struct {
+    pthread_mutex_t verrou;
+    int *taches;
+    int debut;
+    int fin;
+} FileTaches;
+
+typedef struct Ouvrier Ouvrier;
+
+typedef struct {
+    Tache *taches;
+    int n_taches;
+    FileTaches *files;
+    int n_fils;
+    pthread_t *fils;
+    Ouvrier *ouvriers;
+    pthread_mutex_t verrou;     // Guards the fini flags
+    pthread_cond_t cond;
+} Lot;
+
+
+struct Ouvrier {
+    Lot *lot;
+    int id;
+};
+
+static int prend_tache(FileTaches *f, int vol) {
+    int tache = -1;
+
+    pthread_mutex_lock(&f->verrou);
+    if (f->debut < f->fin) {
+        tache = vol ? f->taches[--f->fin] : f->taches[f->debut++];
+    }
+    pthread_mutex_unlock(&f->verrou);
+    return tache;
+}
+
+static int tache_suivante(Lot *lot, int id) {
+    int tache = prend_tache(&lot->files[id], 0);
+    int k;
+
+    for (k = 1; tache < 0 && k < lot->n_fils; k++) {
+        tache = prend_tache(&lot->files[(id + k) % lot->n_fils], 1);
+    }
+    return tache;
+}
+
+// ===================================================
+// Worker
+// ===================================================
+static void trame_stockee(const TrameDemod *trame, void *utilisateur) {
+    Tache *r = utilisateur;
+
+    if (r->n_trames == r->capacite) {
+        int capacite = r->capacite ? 2 * r->capacite : 16;
+        TrameDemod *t = realloc(r->trames, capacite * sizeof(TrameDemod));
+        if (!t) {
+            r->erreur = -1;
+            return;
+        }
+        r->trames = t;
+        r->capacite = capacite;
+    }
+    r->trames[r->n_trames++] = *trame;
+}
+
+static void demodule_tache(Tache *r, short *tampon_ech) {
+    WavMappe propre;
+    const WavMappe *w = r->wav;
+    DemodConfig cfg;
+    Demod1G *demod;
+    const short *ech;
+    size_t pos = r->debut;
+    size_t fin;
+    int n, i;
+
+    if (!w) {
+        r->erreur = wav_mappe_ouvre(&propre, r->chemin);
+        if (r->erreur != 0) return;
+        w = &propre;
+    }
+    fin = (r->fin == 0 || r->fin > w->n_trames) ? w->n_trames : r->fin;
+
+    demod_config_audio(&cfg);
+    cfg.f_ech = w->f_ech;
+    cfg.verbeux = 0;
+    r->f_ech = w->f_ech;
+    demod = demod_cree(&cfg, trame_stockee, r);
+    if (demod) {
+        while (pos < fin) {
+            int m = (fin - pos > BLOC_LOT) ? BLOC_LOT : (int)(fin - pos);
+            n = wav_mappe_lit(w, pos, m, tampon_ech, &ech);
+            if (n == 0) break;
+            demod_alimente(demod, ech, n);
+            pos += n;
+        }
+        demod_vide(demod);
+        r->n_ech = demod_position(demod);
+        demod_detruit(demod);
+        for (i = 0; i < r->n_trames; i++) {
+            r->trames[i].ech += r->debut;
+            r->trames[i].ech_sync += r->debut;
+            r->trames[i].t_sync += r->debut;
+        }
+    } else {
+        r->erreur = -1;
+    }
+
+    if (w == &propre) wav_mappe_ferme(&propre);
+}
+
+static void *ouvrier(void *arg) {
+    Ouvrier *o = arg;
+    Lot *lot = o->lot;
+    short *tampon_ech = malloc(BLOC_LOT * sizeof(short));
+    int tache;
+
+    while ((tache = tache_suivante(lot, o->id)) >= 0) {
+        Tache *r = &lot->taches[tache];
+        if (tampon_ech) {
+            demodule_tache(r, tampon_ech);
+        } else {
+            r->erreur = -1;
+        }
+        pthread_mutex_lock(&lot->verrou);
+        r->fini = 1;
+        pthread_cond_broadcast(&lot->cond);
+        pthread_mutex_unlock(&lot->verrou);
+    }
+
+    free(tampon_ech);
+    return NULL;
+}
+
+// ===================================================
+// Input list
+// ===================================================
+static int compare_chemins(const void *a, const void *b) {
+    return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+static int est_wav(const char *nom) {
+    size_t len = strlen(nom);
+    return len >= 4 && strcasecmp(nom + len - 4, ".wav") == 0;
+}
+
+static int ajoute_chemin(char ***liste, int *n, int *capacite, char *chemin) {
+    if (!chemin) return 1;
+    if (*n == *capacite) {
+        int c = *capacite ? 2 * *capacite : 64;
+        char **l = realloc(*liste, c * sizeof(char *));
+        if (!l) {
+            free(chemin);
+            return 1;
+        }
+        *liste = l;
+        *capacite = c;
+    }
+    (*liste)[(*n)++] = chemin;
+    return 0;
+}
+
+static void libere_chemins(char **chemins, int n) {
+    int i;
+
+    for (i = 0; i < n; i++) {
+        free(chemins[i]);
+    }
+    free(chemins);
+}
+
+// Expand directories to their .wav files, sorted by name
+static char **liste_fichiers(char **entrees, int n_entrees, int *n) {
+    char **liste = NULL;
+    int capacite = 0;
+    int i;
+
+    *n = 0;
+    for (i = 0; i < n_entrees; i++) {
+        struct stat st;
+        DIR *rep;
+        struct dirent *e;
+        int premier = *n;
+
+        if (stat(entrees[i], &st) != 0 || !S_ISDIR(st.st_mode)) {
+            ajoute_chemin(&liste, n, &capacite, strdup(entrees[i]));
+            continue;
+        }
+        rep = opendir(entrees[i]);
+        if (!rep) {
+            fprintf(stderr, "Error: Cannot open directory %s\n", entrees[i]);
+            continue;
+        }
+        while ((e = readdir(rep)) != NULL) {
+            size_t len = strlen(entrees[i]);
+            const char *sep = (len > 0 && entrees[i][len - 1] == '/') ? "" : "/";
+            char *chemin;
+            if (!est_wav(e->d_name)) continue;
+            chemin = malloc(len + strlen(e->d_name) + 2);
+            if (chemin) sprintf(chemin, "%s%s%s", entrees[i], sep, e->d_name);
+            ajoute_chemin(&liste, n, &capacite, chemin);
+        }
+        closedir(rep);
+        qsort(liste + premier, *n - premier, sizeof(char *), compare_chemins);
+    }
+    return liste;
+}
+
+// ===================================================
+// Pool
+// ===================================================
+// Release what lot_demarre set up for the first n_files queues
+static void lot_libere(Lot *lot, int n_files) {
+    int i;
+
+    for (i = 0; i < n_files; i++) {
+        pthread_mutex_destroy(&lot->files[i].verrou);
+        free(lot->files[i].taches);
+    }
+    pthread_mutex_destroy(&lot->verrou);
+    pthread_cond_destroy(&lot->cond);
+    free(lot->files);
+    free(lot->ouvriers);
+    free(lot->fils);
+}
+
+static int lot_demarre(Lot *lot, Tache *taches, int n_taches, int n_fils) {
+    int i, k;
+
+    memset(lot, 0, sizeof(*lot));
+    lot->taches = taches;
+    lot->n_taches = n_taches;
+    lot->n_fils = n_fils;
+    lot->files = calloc(n_fils, sizeof(FileTaches));
+    lot->ouvriers = calloc(n_fils, sizeof(Ouvrier));
+    lot->fils = calloc(n_fils, sizeof(pthread_t));
+    pthread_mutex_init(&lot->verrou, NULL);
+    pthread_cond_init(&lot->cond, NULL);
+    if (!lot->files || !lot->ouvriers || !lot->fils) {
+        fprintf(stderr, "Memory allocation error\n");
+        lot_libere(lot, 0);
+        return 1;
+    }
+
+    for (i = 0; i < n_fils; i++) {
+        FileTaches *f = &lot->files[i];
+        pthread_mutex_init(&f->verrou, NULL);
+        f->taches = malloc((n_taches / n_fils + 1) * sizeof(int));
+        if (!f->taches) {
+            fprintf(stderr, "Memory allocation error\n");
+            lot_libere(lot, i + 1);
+            return 1;
+        }
+        for (k = i; k < n_taches; k += n_fils) {
+            f->taches[f->fin++] = k;
+        }
+    }
+
+    // Kernel selection writes a global, do it before the threads start
+    noyaux_init();
+    for (i = 0; i < n_fils; i++) {
+        lot->ouvriers[i].lot = lot;
+        lot->ouvriers[i].id = i;
+        if (pthread_create(&lot->fils[i], NULL, ouvrier, &lot->ouvriers[i]) != 0) {
+            break;
+        }
+    }
+    if (i < n_fils) {
+        // Empty the queues so the workers already running stop at once
+        fprintf(stderr, "Error: Cannot start worker thread %d\n", i + 1);
+        for (k = 0; k < n_fils; k++) {
+            pthread_mutex_lock(&lot->files[k].verrou);
+            lot->files[k].debut = lot->files[k].fin;
+            pthread_mutex_unlock(&lot->files[k].verrou);
+        }
+        for (k = 0; k < i; k++) {
+            pthread_join(lot->fils[k], NULL);
+        }
+        for (k = 0; k < n_taches; k++) {
+            free(taches[k].trames);
+            taches[k].trames = NULL;
+            taches[k].n_trames = 0;
+        }
+        lot_libere(lot, n_fils);
+        return 1;
+    }
+    return 0;
+}
+
+// Wait until task i is done
+static Tache *lot_attend(Lot *lot, int i) {
+    Tache *r = &lot->taches[i];
+
+    pthread_mutex_lock(&lot->verrou);
+    while (!r->fini) {
+        pthread_cond_wait(&lot->cond, &lot->verrou);
+    }
+    pthread_mutex_unlock(&lot->verrou);
+    return r;
+}
+
+static void lot_termine(Lot *lot) {
+    int i;
+
+    // Queues are shared by stealing, free them once every worker is done
+    for (i = 0; i < lot->n_fils; i++) {
+        pthread_join(lot->fils[i], NULL);
+    }
+    lot_libere(lot, lot->n_fils);
+}
+
+static int nombre_fils(int n_fils, int n_taches) {
+    if (n_fils <= 0) n_fils = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (n_fils < 1) n_fils = 1;
+    if (n_fils > n_taches) n_fils = n_taches;
+    return n_fils;
+}
+
+// ===================================================
+// Batch decoding
+// ===================================================
+static double secondes(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void affiche_erreur(const Tache *r) {
+    if (r->erreur == WAV_ERR_RIFF) {
+        printf("Erreur, ce n'est pas un fichier RIFF/WAVE\n");
+    } else if (r->erreur == WAV_ERR_ENTETE) {
+        printf("Erreur lecture entete\n");
+    } else if (r->erreur != 0) {
+        printf("Error: Cannot decode file %s\n", r->chemin);
+    }
+}
+
+static void affiche_trame(const TrameDemod *t, int numero, int f_ech) {
+    printf("%s frame captured (%d bits)\n",
+           t->bits.longueur == 112 ? "Short" : "Long", t->bits.longueur);
+    affiche_horodatage(t->ech_sync, t->t_sync, f_ech);
+    decode_1g_soft(&t->bits, t->fiabilite);
+    printf("\n--- Frame %d decoded ---\n", numero);
+}
+
+int decode_lot(char **entrees, int n_entrees, int n_fils) {
+    Lot lot;
+    Tache *taches;
+    char **chemins;
+    int n_chemins;
+    int total = 0;
+    int erreurs = 0;
+    long long n_ech = 0;
+    double t0, dt;
+    int i, k;
+
+    chemins = liste_fichiers(entrees, n_entrees, &n_chemins);
+    if (n_chemins == 0) {
+        printf("No WAV files to decode\n");
+        free(chemins);
+        return 0;
+    }
+    taches = calloc(n_chemins, sizeof(Tache));
+    if (!taches) {
+        fprintf(stderr, "Memory allocation error\n");
+        libere_chemins(chemins, n_chemins);
+        return 0;
+    }
+    for (i = 0; i < n_chemins; i++) {
+        taches[i].chemin = chemins[i];
+    }
+
+    n_fils = nombre_fils(n_fils, n_chemins);
+    printf("Batch decoding %d files on %d threads\n", n_chemins, n_fils);
+    t0 = secondes();
+    if (lot_demarre(&lot, taches, n_chemins, n_fils) != 0) {
+        libere_chemins(chemins, n_chemins);
+        free(taches);
+        return 0;
+    }
+
+    // Report files in input order as soon as each one is done
+    for (i = 0; i < n_chemins; i++) {
+        Tache *r = lot_attend(&lot, i);
+
+        printf("\n=== %s ===\n", r->chemin);
+        affiche_erreur(r);
+        for (k = 0; k < r->n_trames; k++) {
+            affiche_trame(&r->trames[k], k + 1, r->f_ech);
+        }
+        if (r->erreur == 0) {
+            printf("Frames in file: %d\n", r->n_trames);
+        } else {
+            erreurs++;
+        }
+        total += r->n_trames;
+        n_ech += r->n_ech;
+        free(r->trames);
+        r->trames = NULL;
+    }
+
+    lot_termine(&lot);
+    dt = secondes() - t0;
+    if (dt <= 0.0) dt = 1e-9;
+
+    printf("\n=== Batch summary ===\n");
+    printf("Files: %d (%d errors)\n", n_chemins, erreurs);
+    printf("Total frames decoded: %d\n", total);
+    printf("Elapsed: %.3f s on %d threads\n", dt, n_fils);
+    printf("Throughput: %.1f files/s, %.1f Msamples/s\n",
+           n_chemins / dt, n_ech / dt / 1e6);
+
+    libere_chemins(chemins, n_chemins);
+    free(taches);
+    return total;
+}
+
+// ===================================================
+// Segmented decoding of one long recording
+// ===================================================
+// The file is cut into segments decoded independently. Each segment is
+// decoded from one overlap before its start, so that thresholds settle,
+// to one overlap past its end, so that a frame straddling the boundary
+// completes. Frames synced in the lead-in are left to the previous
+// segment, which saw them with its full history. Frames both segments see
+// after the boundary are matched by sync position and reported once.
+// Segment starts are multiples of the decimation ratio so that every
+// segment sees the same decimated sample grid.
+
+// Segments per thread, for load balancing
+#define SEGMENTS_PAR_FIL 4
+// Shortest segment worth a task (seconds)
+#define SEGMENT_MIN_S 30.0
+// Overlap: twice a long frame with its 160 ms unmodulated preamble
+#define CHEVAUCHEMENT_S(bauds) (2.0 * (0.160 + 144.0 / (bauds)))
+
+int decode_segments(const char *chemin, int n_fils) {
+    WavMappe w;
+    Lot lot;
+    Tache *taches;
+    int n_segments;
+    size_t longueur, chevauchement, pos;
+    int facteur;
+    int total = 0;
+    long long fin_derniere = -1;
+    double t0, dt;
+    int i, k;
+
+    int err = wav_mappe_ouvre(&w, chemin);
+    if (err != 0) {
+        Tache r;
+        memset(&r, 0, sizeof(r));
+        r.chemin = chemin;
+        r.erreur = err;
+        affiche_erreur(&r);
+        return 0;
+    }
+
+    if (n_fils <= 0) n_fils = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (n_fils < 1) n_fils = 1;
+    facteur = decim_facteur(w.f_ech, bauds, decimation);
+    chevauchement = (size_t)(CHEVAUCHEMENT_S(bauds) * w.f_ech);
+    longueur = w.n_trames / ((size_t)n_fils * SEGMENTS_PAR_FIL) + 1;
+    if (longueur < SEGMENT_MIN_S * w.f_ech) longueur = SEGMENT_MIN_S * w.f_ech;
+    if (longueur < 4 * chevauchement) longueur = 4 * chevauchement;
+    longueur -= longueur % facteur;
+    chevauchement += facteur - chevauchement % facteur;
+    n_segments = (int)((w.n_trames + longueur - 1) / longueur);
+    if (n_segments < 1) n_segments = 1;
+
+    taches = calloc(n_segments, sizeof(Tache));
+    if (!taches) {
+        fprintf(stderr, "Memory allocation error\n");
+        wav_mappe_ferme(&w);
+        return 0;
+    }
+    for (i = 0, pos = 0; i < n_segments; i++, pos += longueur) {
+        taches[i].chemin = chemin;
+        taches[i].wav = &w;
+        taches[i].debut = (pos > chevauchement) ? pos - chevauchement : 0;
+        taches[i].propre = pos;
+        taches[i].fin = (i == n_segments - 1) ? 0 : pos + longueur + chevauchement;
+    }
+
+    n_fils = nombre_fils(n_fils, n_segments);
+    printf("Segmented decoding: %d segments of %.1f s (overlap %.2f s) on %d threads\n",
+           n_segments, (double)longueur / w.f_ech,
+           (double)chevauchement / w.f_ech, n_fils);
+    t0 = secondes();
+    if (lot_demarre(&lot, taches, n_segments, n_fils) != 0) {
+        free(taches);
+        wav_mappe_ferme(&w);
+        return 0;
+    }
+
+    // Merge in time order. Frames are placed by their sync, which does not
+    // depend on the decoder history; a frame whose sync falls inside the
+    // last one kept is the same burst seen again or a false sync in it.
+    for (i = 0; i < n_segments; i++) {
+        Tache *r = lot_attend(&lot, i);
+
+        if (r->erreur != 0) affiche_erreur(r);
+        for (k = 0; k < r->n_trames; k++) {
+            const TrameDemod *t = &r->trames[k];
+            if (t->ech_sync < (long long)r->propre ||
+                t->ech_sync < fin_derniere) continue;
+            fin_derniere = t->ech_sync +
+                (long long)(t->bits.longueur - 15) * w.f_ech / bauds;
+            affiche_trame(t, ++total, w.f_ech);
+        }
+        free(r->trames);
+        r->trames = NULL;
+    }
+
+    lot_termine(&lot);
+    dt = secondes() - t0;
+    if (dt <= 0.0) dt = 1e-9;
+
+    printf("\nTotal frames decoded: %d\n", total);
+    printf("Elapsed: %.3f s on %d threads\n", dt, n_fils);
+    printf("Throughput: %.1f Msamples/s (%.0fx real time)\n",
+           w.n_trames / dt / 1e6, (double)w.n_trames / w.f_ech / dt);
+
+    free(taches);
+    wav_mappe_ferme(&w);
+    return total;
+}
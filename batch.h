@@ -0,0 +1,41 @@
+/**********************************
+
+## Licence
+
+ Licence Creative Commons CC BY-NC-SA 
+
+## Auteurs et contributions
+
+- **Code original dec406_v7** : F4EHY (2020)
+- **Refactoring et support 2G** : Développement collaboratif (2025)
+- **Conformité T.018** : Implémentation complète BCH + MID database
+
+***********************************/
+
+// batch.h - Parallel decoding of many WAV recordings or of one long one
+#ifndef BATCH_H
+#define BATCH_H
+
+/**
+ * Decode many WAV files on a pool of worker threads
+ * Directories are expanded to the .wav files they contain, sorted by name.
+ * Workers only demodulate; frames are decoded and printed file by file,
+ * in input order, followed by a throughput summary.
+ * @param entrees WAV files or directories
+ * @param n_entrees Number of entries
+ * @param n_fils Number of worker threads, 0 for one per CPU
+ * @return Total number of frames decoded
+ */
+int decode_lot(char **entrees, int n_entrees, int n_fils);
+
+/**
+ * Decode one long WAV file as overlapping segments on a pool of threads
+ * Segments overlap by more than a long frame and its preamble; frames
+ * seen twice in an overlap are merged by sample position.
+ * @param chemin WAV file
+ * @param n_fils Number of worker threads, 0 for one per CPU
+ * @return Number of frames decoded
+ */
+int decode_segments(const char *chemin, int n_fils);
+
+#endif // BATCH_H
@@ -0,0 +1,450 @@
+/**********************************
+
+## Licence
+
+ Licence Creative Commons CC BY-NC-SA 
+
+## Auteurs et contributions
+
+- **Code original dec406_v7** : F4EHY (2020)
+- **Refactoring et support 2G** : Développement collaboratif (2025)
+- **Conformité T.018** : Implémentation complète BCH + MID database
+
+***********************************/
+
+// bch406.c - BCH checks and correction of 1G and 2G frames, table driven
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "bch406.h"
+
+// ===================================================
+// Byte tables, built by the compiler
+// ===================================================
+// One division step of an r-bit register by g (x^r term implied)
+#define BCH_MASQUE(r) ((1u << (r)) - 1)
+#define BCH_PAS(v, g, r) \
+    ((((v) << 1) ^ ((((v) >> ((r) - 1)) & 1) ? (g) : 0)) & BCH_MASQUE(r))
+
+// x^(r+k) mod g for k = 0..7: the table is linear in the input byte
+enum {
+    BCH1_X0 = BCH1_POLY & BCH_MASQUE(BCH1_DEGRE),
+    BCH1_X1 = BCH_PAS(BCH1_X0, BCH1_POLY, BCH1_DEGRE),
+    BCH1_X2 = BCH_PAS(BCH1_X1, BCH1_POLY, BCH1_DEGRE),
+    BCH1_X3 = BCH_PAS(BCH1_X2, BCH1_POLY, BCH1_DEGRE),
+    BCH1_X4 = BCH_PAS(BCH1_X3, BCH1_POLY, BCH1_DEGRE),
+    BCH1_X5 = BCH_PAS(BCH1_X4, BCH1_POLY, BCH1_DEGRE),
+    BCH1_X6 = BCH_PAS(BCH1_X5, BCH1_POLY, BCH1_DEGRE),
+    BCH1_X7 = BCH_PAS(BCH1_X6, BCH1_POLY, BCH1_DEGRE),
+
+    BCH2_X0 = BCH2_POLY & BCH_MASQUE(BCH2_DEGRE),
+    BCH2_X1 = BCH_PAS(BCH2_X0, BCH2_POLY, BCH2_DEGRE),
+    BCH2_X2 = BCH_PAS(BCH2_X1, BCH2_POLY, BCH2_DEGRE),
+    BCH2_X3 = BCH_PAS(BCH2_X2, BCH2_POLY, BCH2_DEGRE),
+    BCH2_X4 = BCH_PAS(BCH2_X3, BCH2_POLY, BCH2_DEGRE),
+    BCH2_X5 = BCH_PAS(BCH2_X4, BCH2_POLY, BCH2_DEGRE),
+    BCH2_X6 = BCH_PAS(BCH2_X5, BCH2_POLY, BCH2_DEGRE),
+    BCH2_X7 = BCH_PAS(BCH2_X6, BCH2_POLY, BCH2_DEGRE),
+};
+
+// Entry for byte i: (i * x^r) mod g
+#define BCH_E(i, p) \
+    (((i) & 0x01 ? p##_X0 : 0) ^ ((i) & 0x02 ? p##_X1 : 0) ^ \
+     ((i) & 0x04 ? p##_X2 : 0) ^ ((i) & 0x08 ? p##_X3 : 0) ^ \
+     ((i) & 0x10 ? p##_X4 : 0) ^ ((i) & 0x20 ? p##_X5 : 0) ^ \
+     ((i) & 0x40 ? p##_X6 : 0) ^ ((i) & 0x80 ? p##_X7 : 0))
+#define BCH_L4(i, p) BCH_E(i, p), BCH_E((i) + 1, p), BCH_E((i) + 2, p), BCH_E((i) + 3, p)
+#define BCH_L16(i, p) BCH_L4(i, p), BCH_L4((i) + 4, p), BCH_L4((i) + 8, p), BCH_L4((i) + 12, p)
+#define BCH_L64(i, p) BCH_L16(i, p), BCH_L16((i) + 16, p), BCH_L16((i) + 32, p), BCH_L16((i) + 48, p)
+#define BCH_L256(p) BCH_L64(0, p), BCH_L64(64, p), BCH_L64(128, p), BCH_L64(192, p)
+
+static const uint32_t table_bch1[256] = { BCH_L256(BCH1) };
+static const uint32_t table_bch2[256] = { BCH_L256(BCH2) };
+
+// ===================================================
+// Remainders
+// ===================================================
+// Bits [debut, debut+n) times x^r mod g, one byte per lookup. Leading zero
+// bits leave the remainder unchanged, so the odd bits go first as a short
+// byte. With g(0) = 1 the result is zero exactly when the codeword divides.
+static uint32_t reste(const Trame406 *t, int debut, int n,
+                      const uint32_t *table, int r) {
+    uint32_t reg = 0;
+    int tete = n & 7;
+
+    if (tete) {
+        reg = table[trame406_champ(t, debut, tete)];
+        debut += tete;
+        n -= tete;
+    }
+    for (; n > 0; debut += 8, n -= 8) {
+        uint32_t octet = trame406_champ(t, debut, 8);
+        reg = ((reg << 8) ^ table[((reg >> (r - 8)) ^ octet) & 0xFF]) & BCH_MASQUE(r);
+    }
+    return reg;
+}
+
+uint32_t bch1_reste(const Trame406 *t) {
+    return reste(t, BCH1_DEBUT, BCH1_N, table_bch1, BCH1_DEGRE);
+}
+
+uint32_t bch2_reste(const Trame406 *t) {
+    return reste(t, BCH2_DEBUT, BCH2_N, table_bch2, BCH2_DEGRE);
+}
+
+// ===================================================
+// Correction tables
+// ===================================================
+// Syndromes of every pattern of one or two errors, sorted for a binary
+// search; a third error is found by trying each position against them
+typedef struct {
+    uint32_t syndrome;
+    uint8_t i, j;               // Codeword positions, j == i for one error
+} Motif;
+
+typedef struct {
+    int debut, n;               // Codeword bits in the frame
+    int t;                      // Errors corrected
+    uint32_t (*reste)(const Trame406 *t);
+    uint32_t syndrome[BCH1_N];  // Syndrome of a single error
+    Motif *motifs;
+    int n_motifs;
+} CodeBCH;
+
+static Motif motifs_bch1[BCH1_N * (BCH1_N + 1) / 2];
+static Motif motifs_bch2[BCH2_N * (BCH2_N + 1) / 2];
+static CodeBCH code_bch1 = { BCH1_DEBUT, BCH1_N, 3, bch1_reste, { 0 }, motifs_bch1, 0 };
+static CodeBCH code_bch2 = { BCH2_DEBUT, BCH2_N, 2, bch2_reste, { 0 }, motifs_bch2, 0 };
+static pthread_once_t tables_pretes = PTHREAD_ONCE_INIT;
+
+// 2G: byte table of the 48-bit remainder, GF(2^8) log/antilog, and the
+// odd syndromes S1, S3 .. S11 of each remainder byte packed in 8-bit lanes
+#define BCH2G_MASQUE ((1ULL << BCH2G_DEGRE) - 1)
+static uint64_t table_bch2g[256];
+static uint8_t gf_exp[2 * 255];
+static uint8_t gf_log[256];
+static uint64_t table_syndromes[BCH2G_DEGRE / 8][256];
+
+static int compare_motifs(const void *a, const void *b) {
+    const Motif *ma = a, *mb = b;
+    return (ma->syndrome > mb->syndrome) - (ma->syndrome < mb->syndrome);
+}
+
+static void prepare_code(CodeBCH *c) {
+    Trame406 e;
+    int i, j;
+
+    for (i = 0; i < c->n; i++) {
+        trame406_efface(&e, TRAME406_BITS_MAX);
+        trame406_met(&e, c->debut + i, 1);
+        c->syndrome[i] = c->reste(&e);
+    }
+    c->n_motifs = 0;
+    for (i = 0; i < c->n; i++) {
+        for (j = i; j < c->n; j++) {
+            Motif *m = &c->motifs[c->n_motifs++];
+            m->syndrome = (i == j) ? c->syndrome[i] : c->syndrome[i] ^ c->syndrome[j];
+            m->i = i;
+            m->j = j;
+        }
+    }
+    qsort(c->motifs, c->n_motifs, sizeof(Motif), compare_motifs);
+}
+
+static void prepare_bch2g(void) {
+    int i, k, b, l, x = 1;
+
+    for (i = 0; i < 255; i++) {
+        gf_exp[i] = gf_exp[i + 255] = x;
+        gf_log[x] = i;
+        x <<= 1;
+        if (x & 0x100) x ^= GF256_POLY;
+    }
+
+    for (i = 0; i < 256; i++) {
+        uint64_t v = (uint64_t)i << (BCH2G_DEGRE - 8);
+        for (k = 0; k < 8; k++) {
+            v = ((v << 1) ^ ((v >> (BCH2G_DEGRE - 1)) & 1 ? BCH2G_POLY : 0)) & BCH2G_MASQUE;
+        }
+        table_bch2g[i] = v;
+    }
+
+    // Remainder bit 8b+k is the coefficient of x^(8b+k): S_j gets alpha^(j(8b+k))
+    for (b = 0; b < BCH2G_DEGRE / 8; b++) {
+        for (i = 0; i < 256; i++) {
+            uint64_t w = 0;
+            for (l = 0; l < BCH2G_T; l++) {
+                const int j = 2 * l + 1;
+                uint64_t s = 0;
+                for (k = 0; k < 8; k++) {
+                    if ((i >> k) & 1) s ^= gf_exp[(j * (8 * b + k)) % 255];
+                }
+                w |= s << (8 * l);
+            }
+            table_syndromes[b][i] = w;
+        }
+    }
+}
+
+static void prepare_tables(void) {
+    prepare_code(&code_bch1);
+    prepare_code(&code_bch2);
+    prepare_bch2g();
+}
+
+static const Motif *cherche_motif(const CodeBCH *c, uint32_t syndrome) {
+    Motif cle;
+    cle.syndrome = syndrome;
+    return bsearch(&cle, c->motifs, c->n_motifs, sizeof(Motif), compare_motifs);
+}
+
+static void inverse(Trame406 *t, int pos) {
+    trame406_met(t, pos, !trame406_bit(t, pos));
+}
+
+// ===================================================
+// Correction
+// ===================================================
+static int corrige(const CodeBCH *c, Trame406 *t) {
+    const uint32_t s = c->reste(t);
+    const Motif *m;
+    int p;
+
+    if (s == 0) return 0;
+
+    m = cherche_motif(c, s);
+    if (m) {
+        inverse(t, c->debut + m->i);
+        if (m->j == m->i) return 1;
+        inverse(t, c->debut + m->j);
+        return 2;
+    }
+    if (c->t < 3) return -1;
+
+    // Three errors: p plus a pair of other positions
+    for (p = 0; p < c->n; p++) {
+        m = cherche_motif(c, s ^ c->syndrome[p]);
+        if (m && m->i != m->j && m->i != p && m->j != p) {
+            inverse(t, c->debut + p);
+            inverse(t, c->debut + m->i);
+            inverse(t, c->debut + m->j);
+            return 3;
+        }
+    }
+    return -1;
+}
+
+int bch1_corrige(Trame406 *t) {
+    pthread_once(&tables_pretes, prepare_tables);
+    return corrige(&code_bch1, t);
+}
+
+int bch2_corrige(Trame406 *t) {
+    pthread_once(&tables_pretes, prepare_tables);
+    return corrige(&code_bch2, t);
+}
+
+// ===================================================
+// 2G: BCH (250,202), Berlekamp-Massey and Chien search
+// ===================================================
+static inline uint8_t gf_mul(uint8_t a, uint8_t b) {
+    return (a && b) ? gf_exp[gf_log[a] + gf_log[b]] : 0;
+}
+
+static inline uint8_t gf_div(uint8_t a, uint8_t b) {
+    return a ? gf_exp[gf_log[a] + 255 - gf_log[b]] : 0;
+}
+
+uint64_t bch2g_reste(const Trame406 *t) {
+    uint64_t reg = 0;
+    int debut = 0, n = BCH2G_K;
+    const int tete = n & 7;
+
+    pthread_once(&tables_pretes, prepare_tables);
+
+    // Information bits times x^48 mod g, then the parity bits as they are
+    if (tete) {
+        reg = table_bch2g[trame406_champ(t, debut, tete)];
+        debut += tete;
+        n -= tete;
+    }
+    for (; n > 0; debut += 8, n -= 8) {
+        uint32_t octet = trame406_champ(t, debut, 8);
+        reg = ((reg << 8) ^ table_bch2g[((reg >> (BCH2G_DEGRE - 8)) ^ octet) & 0xFF]) & BCH2G_MASQUE;
+    }
+    return reg ^ ((uint64_t)trame406_champ(t, BCH2G_K, 16) << 32)
+               ^ trame406_champ(t, BCH2G_K + 16, 32);
+}
+
+// Error locator of degree L from S1..S2t, or -1 past t errors
+static int berlekamp_massey(const uint8_t *S, uint8_t *lambda) {
+    uint8_t b[2 * BCH2G_T + 1] = { 1 };
+    uint8_t prec[2 * BCH2G_T + 1];
+    uint8_t bd = 1;
+    int L = 0, m = 1;
+    int n, i;
+
+    memset(lambda, 0, 2 * BCH2G_T + 1);
+    lambda[0] = 1;
+
+    for (n = 0; n < 2 * BCH2G_T; n++) {
+        uint8_t d, coef;
+        if (n & 1) {  // Binary code: S_2j = S_j^2 zeroes every odd discrepancy
+            m++;
+            continue;
+        }
+        d = S[n + 1];
+        for (i = 1; i <= L; i++) d ^= gf_mul(lambda[i], S[n + 1 - i]);
+        if (d == 0) {
+            m++;
+            continue;
+        }
+
+        coef = gf_div(d, bd);
+        memcpy(prec, lambda, sizeof(prec));
+        for (i = 0; i + m <= 2 * BCH2G_T; i++) lambda[i + m] ^= gf_mul(coef, b[i]);
+        if (2 * L <= n) {
+            L = n + 1 - L;
+            memcpy(b, prec, sizeof(b));
+            bd = d;
+            m = 1;
+        } else {
+            m++;
+        }
+    }
+    return L <= BCH2G_T ? L : -1;
+}
+
+// Lane-wise x * alpha^-1 on the 8-bit lanes selected by masque
+static inline uint64_t gf_div_alpha(uint64_t w, uint64_t masque) {
+    const uint64_t x = w & masque;
+    const uint64_t bas = x & 0x0101010101010101ULL;
+    return (w & ~masque) | (((x >> 1) & 0x7F7F7F7F7F7F7F7FULL) ^ (bas * (GF256_POLY >> 1)));
+}
+
+// Roots of lambda among the 250 positions; degree e is frame bit 249 - e.
+// Fewer than L roots means the errors fall outside the shortened code.
+// Lambda_1..Lambda_L sit in lanes 0..L-1 and lane k-1 steps by alpha^-k,
+// so one word holds every term of lambda(alpha^-e).
+static int chien(const uint8_t *lambda, int L, int *positions) {
+    uint64_t w = 0, masques[BCH2G_T];
+    int e, k, n = 0;
+
+    for (k = 1; k <= L; k++) {
+        w |= (uint64_t)lambda[k] << (8 * (k - 1));
+        masques[k - 1] = BCH2G_MASQUE & ~((1ULL << (8 * (k - 1))) - 1);
+    }
+
+    for (e = 0; e < BCH2G_N; e++) {
+        uint64_t v = w ^ (w >> 32);
+        v ^= v >> 16;
+        v ^= v >> 8;
+        if (((v ^ 1) & 0xFF) == 0) {
+            positions[n++] = BCH2G_N - 1 - e;
+            if (n == L) break;  // A degree L locator has no more roots
+        }
+        for (k = 0; k < L; k++) w = gf_div_alpha(w, masques[k]);
+    }
+    return n;
+}
+
+int bch2g_corrige(Trame406 *t) {
+    const uint64_t r = bch2g_reste(t);
+    uint8_t S[2 * BCH2G_T + 1];
+    uint8_t lambda[2 * BCH2G_T + 1];
+    int positions[BCH2G_T];
+    uint64_t w = 0;
+    int L, b, j;
+
+    if (r == 0) return 0;
+
+    // S_j = r(alpha^j) since g(alpha^j) = 0; even ones are squares
+    for (b = 0; b < BCH2G_DEGRE / 8; b++) {
+        w ^= table_syndromes[b][(r >> (8 * b)) & 0xFF];
+    }
+    for (j = 1; j <= 2 * BCH2G_T; j++) {
+        S[j] = (j & 1) ? (w >> (4 * (j - 1))) & 0xFF : gf_mul(S[j / 2], S[j / 2]);
+    }
+
+    L = berlekamp_massey(S, lambda);
+    if (L <= 0 || chien(lambda, L, positions) != L) return -1;
+
+    for (j = 0; j < L; j++) {
+        trame406_met(t, positions[j], !trame406_bit(t, positions[j]));
+    }
+    return L;
+}
+
+// ===================================================
+// Chase decoding
+// ===================================================
+// Chase-2: every pattern of flips over the p least reliable bits of the
+// codeword goes through the hard decoder, and the candidate whose changed
+// bits add up to the least reliability wins. With a_i = min(fiabilite,
+// CHASE_FIABLE) / CHASE_FIABLE, a frame whose mean 1 - a_i reaches 1/8 is
+// noise rather than a damaged codeword and is not tried, and a candidate
+// is kept only if its changed bits weigh less than 3/8 of d certain bits
+// (the GMD bound would be d/2 with the weak bits counted against it).
+// On simulated channels this recovers most of the frames past hard
+// correction while miscorrecting no more often than hard decoding does.
+static int chase(Trame406 *t, const uint8_t *fiabilite, int debut, int n, int p,
+                 int d, int (*corrige)(Trame406 *t)) {
+    int faibles[CHASE2G_P];     // Largest p of the three codes
+    int n_faibles = 0, base = 0, meilleur_poids = -1, meilleurs_changes = 0;
+    Trame406 meilleur;
+    unsigned motif;
+    int i, k;
+
+    for (i = debut; i < debut + n; i++) {
+        const int a = fiabilite[i] < CHASE_FIABLE ? fiabilite[i] : CHASE_FIABLE;
+        base += CHASE_FIABLE - a;
+
+        // The p least reliable positions, by insertion
+        if (n_faibles == p && fiabilite[i] >= fiabilite[faibles[p - 1]]) continue;
+        k = (n_faibles < p) ? n_faibles++ : p - 1;
+        while (k > 0 && fiabilite[faibles[k - 1]] > fiabilite[i]) {
+            faibles[k] = faibles[k - 1];
+            k--;
+        }
+        faibles[k] = i;
+    }
+    if (8 * base >= n * CHASE_FIABLE) return -1;
+
+    for (motif = 0; motif < (1u << n_faibles); motif++) {
+        Trame406 c = *t;
+        int poids = 0, changes = 0;
+
+        for (k = 0; k < n_faibles; k++) {
+            if ((motif >> k) & 1) inverse(&c, faibles[k]);
+        }
+        if (corrige(&c) < 0) continue;
+
+        for (i = debut; i < debut + n; i++) {
+            if (trame406_bit(&c, i) == trame406_bit(t, i)) continue;
+            poids += fiabilite[i] < CHASE_FIABLE ? fiabilite[i] : CHASE_FIABLE;
+            changes++;
+        }
+        if (8 * poids >= 3 * d * CHASE_FIABLE) continue;
+        if (meilleur_poids < 0 || poids < meilleur_poids) {
+            meilleur = c;
+            meilleur_poids = poids;
+            meilleurs_changes = changes;
+        }
+    }
+
+    if (meilleur_poids < 0) return -1;
+    *t = meilleur;
+    return meilleurs_changes;
+}
+
+int bch1_chase(Trame406 *t, const uint8_t *fiabilite) {
+    return chase(t, fiabilite, BCH1_DEBUT, BCH1_N, CHASE1_P, 7, bch1_corrige);
+}
+
+int bch2_chase(Trame406 *t, const uint8_t *fiabilite) {
+    return chase(t, fiabilite, BCH2_DEBUT, BCH2_N, CHASE2_P, 5, bch2_corrige);
+}
+
+int bch2g_chase(Trame406 *t, const uint8_t *fiabilite) {
+    return chase(t, fiabilite, 0, BCH2G_N, CHASE2G_P, 2 * BCH2G_T + 1, bch2g_corrige);
+}
@@ -0,0 +1,119 @@
+/**********************************
+
+## Licence
+
+ Licence Creative Commons CC BY-NC-SA 
+
+## Auteurs et contributions
+
+- **Code original dec406_v7** : F4EHY (2020)
+- **Refactoring et support 2G** : Développement collaboratif (2025)
+- **Conformité T.018** : Implémentation complète BCH + MID database
+
+***********************************/
+
+// bch406.h - BCH checks and correction of 1G and 2G frames, table driven
+#ifndef BCH406_H
+#define BCH406_H
+
+#include <stdint.h>
+#include "trame406.h"
+
+// T.001 BCH-1 (82,61) over bits 25-106, corrects 3 errors;
+// BCH-2 (38,26) over bits 107-144, corrects 2 errors
+#define BCH1_POLY 0x26D9E3u
+#define BCH1_DEGRE 21
+#define BCH1_DEBUT 24
+#define BCH1_N 82
+#define BCH2_POLY 0x1539u
+#define BCH2_DEGRE 12
+#define BCH2_DEBUT 106
+#define BCH2_N 38
+
+// T.018 BCH (250,202) over bits 1-250 of a 2G frame, corrects 6 errors;
+// shortened BCH (255,207) over GF(2^8) built on x^8+x^4+x^3+x^2+1
+#define BCH2G_POLY 0x1C7EB85DF3C97ULL
+#define BCH2G_DEGRE 48
+#define BCH2G_N 250
+#define BCH2G_K 202
+#define BCH2G_T 6
+#define GF256_POLY 0x11D
+
+// Chase decoding: flip patterns over this many least reliable bits
+// (2^p hard decodings); a bit this reliable or more counts as certain
+#define CHASE1_P 4
+#define CHASE2_P 3
+#define CHASE2G_P 6
+#define CHASE_FIABLE 64
+
+/**
+ * Remainder of PDF-1 and BCH-1 (bits 25-106) by the BCH-1 generator
+ * @param t 1G frame
+ * @return Remainder, 0 for a valid codeword
+ */
+uint32_t bch1_reste(const Trame406 *t);
+
+/**
+ * Remainder of PDF-2 and BCH-2 (bits 107-144) by the BCH-2 generator
+ * @param t 1G frame
+ * @return Remainder, 0 for a valid codeword
+ */
+uint32_t bch2_reste(const Trame406 *t);
+
+/**
+ * Correct up to 3 bit errors in PDF-1 and BCH-1
+ * @param t 1G frame, corrected in place
+ * @return Bits corrected (0 for a valid codeword), -1 if uncorrectable;
+ *         the frame is left unchanged when uncorrectable
+ */
+int bch1_corrige(Trame406 *t);
+
+/**
+ * Correct up to 2 bit errors in PDF-2 and BCH-2
+ * @param t Long 1G frame, corrected in place
+ * @return Bits corrected (0 for a valid codeword), -1 if uncorrectable;
+ *         the frame is left unchanged when uncorrectable
+ */
+int bch2_corrige(Trame406 *t);
+
+/**
+ * Remainder of a 2G codeword (bits 1-250) by the T.018 generator
+ * @param t 2G frame
+ * @return Remainder, 0 for a valid codeword
+ */
+uint64_t bch2g_reste(const Trame406 *t);
+
+/**
+ * Correct up to 6 bit errors in a 2G frame (Berlekamp-Massey, Chien search)
+ * @param t 2G frame, corrected in place
+ * @return Bits corrected (0 for a valid codeword), -1 if uncorrectable;
+ *         the frame is left unchanged when uncorrectable
+ */
+int bch2g_corrige(Trame406 *t);
+
+/**
+ * Chase decoding of PDF-1 and BCH-1, for frames beyond hard correction
+ * @param t 1G frame, corrected in place
+ * @param fiabilite Per-bit reliability indexed like the frame bits,
+ *                  0 least reliable, 128 for a typical bit
+ * @return Bits changed, -1 if no candidate passes (frame unchanged)
+ */
+int bch1_chase(Trame406 *t, const uint8_t *fiabilite);
+
+/**
+ * Chase decoding of PDF-2 and BCH-2, for frames beyond hard correction
+ * @param t Long 1G frame, corrected in place
+ * @param fiabilite Per-bit reliability, as for bch1_chase()
+ * @return Bits changed, -1 if no candidate passes (frame unchanged)
+ */
+int bch2_chase(Trame406 *t, const uint8_t *fiabilite);
+
+/**
+ * Chase decoding of a 2G frame, for frames beyond hard correction
+ * @param t 2G frame, corrected in place
+ * @param fiabilite Per-bit reliability, as for bch1_chase()
+ * @return Bits changed, -1 if no candidate passes (frame unchanged)
+ */
+int bch2g_chase(Trame406 *t, const uint8_t *fiabilite);
+
+#endif // BCH406_H
@@ -0,0 +1,472 @@
+/**********************************
+
+## Licence
+
+ Licence Creative Commons CC BY-NC-SA 
+
+## Auteurs et contributions
+
+- **Code original dec406_v7** : F4EHY (2020)
+- **Refactoring et support 2G** : Développement collaboratif (2025)
+- **Conformité T.018** : Implémentation complète BCH + MID database
+
+***********************************/
+
+// channelizer.c - Wideband IQ split into the T.012 channels, one decoder each
+//
+// Fast-convolution filter bank (overlap-save). Each block of N input
+// samples, the last N/4 of them shared with the previous block, goes
+// through one N-point FFT. The energy of every channel is read from the
+// bins around its frequency; only channels above the noise floor (or
+// still in their hold time) are demodulated. For those, the K bins around
+// the channel are weighted by the channel filter and brought back to time
+// by a K-point inverse FFT, which gives 3K/4 new baseband samples at
+// f_iq*K/N. Each channel owns a phase demodulator and a Demod1G.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "channelizer.h"
+#include "fft.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Recent frames kept to merge a burst seen on neighbouring channels
+#define CANAL_RECENTES 16
+#define CANAL_ATTENTE_MAX 64
+
+// Two frames are the same burst if their syncs are this close (s)
+// and their channels at most two apart
+#define CANAL_MEME_SALVE_S 0.020
+
+// ===================================================
+// State
+// ===================================================
+typedef struct {
+    int index;              // 0 for channel A
+    double f;               // Channel frequency (Hz)
+    int k0;                 // FFT bin of the channel, 0..N-1
+    PhaseIQ phase;
+    Demod1G *demod;
+    int maintien;           // Blocks left before sleeping, 0 if asleep
+    long long base;         // Channel sample of demodulator sample 0
+    double niveau;          // Highest energy over the median since waking (dB)
+} Canal;
+
+struct Canaliseur {
+    FormatIQ format;
+    int f_iq;
+    double f_centre;
+    int N;                  // Wideband FFT size
+    int K;                  // Channel FFT size (N/K = decimation)
+    int L;                  // New input samples per block (3N/4)
+    PlanFFT grand;
+    PlanFFT petit;
+    float *H_re, *H_im;     // Channel filter response, K bins around 0
+    float *x_re, *x_im;     // Block input, N/4 of history then L new
+    float *X_re, *X_im;     // Block spectrum
+    float *y_re, *y_im;     // Channel spectrum then samples
+    short *sortie;
+    int remplissage;        // New samples in the current block
+    int demi_bande;         // Bins on each side counted for energy
+    int maintien;           // Hold time in blocks
+    double seuil;           // Wake-up threshold over the median (ratio)
+    double *energies;
+    Canal canaux[N_CANAUX_T012];
+    int n_canaux;
+    long long n_blocs;
+    long long n_entree;
+    canal_trame_cb cb;
+    void *utilisateur;
+    Canal *courant;         // Channel being demodulated, for the callback
+    TrameCanal attente[CANAL_ATTENTE_MAX];
+    long long bloc_attente[CANAL_ATTENTE_MAX];
+    int n_attente;
+    long long n_perdues;    // Frames dropped with the hold buffer full
+    TrameCanal recentes[CANAL_RECENTES];
+    int n_recentes;
+    int pos_recentes;
+};
+
+// ===================================================
+// Frames
+// ===================================================
+static int meme_salve(const Canaliseur *c, const TrameCanal *a, const TrameCanal *b) {
+    long long dt = a->trame.ech_sync - b->trame.ech_sync;
+    if (dt < 0) dt = -dt;
+    return abs(a->canal - b->canal) <= 2 && dt < CANAL_MEME_SALVE_S * c->f_iq;
+}
+
+static void trame_canal(const TrameDemod *trame, void *utilisateur) {
+    Canaliseur *c = utilisateur;
+    Canal *k = c->courant;
+    const int D = c->N / c->K;
+    TrameCanal *t;
+
+    if (c->n_attente == CANAL_ATTENTE_MAX) {
+        c->n_perdues++;
+        return;
+    }
+    t = &c->attente[c->n_attente];
+    c->bloc_attente[c->n_attente] = c->n_blocs;
+    c->n_attente++;
+    t->trame = *trame;
+    t->trame.ech = (trame->ech + k->base) * D;
+    t->trame.ech_sync = (trame->ech_sync + k->base) * D;
+    t->trame.t_sync = (trame->t_sync + k->base) * D;
+    t->canal = k->index;
+    t->f_canal = k->f;
+    t->niveau = k->niveau;
+}
+
+static int compare_niveaux(const void *a, const void *b) {
+    const TrameCanal *ta = a, *tb = b;
+    return (ta->niveau < tb->niveau) - (ta->niveau > tb->niveau);
+}
+
+// Report held frames captured before block 'avant', strongest first;
+// a weaker copy of the same burst is dropped even if the strongest one
+// has to wait for the next block
+static int emet_trames(Canaliseur *c, long long avant) {
+    TrameCanal gardees[CANAL_ATTENTE_MAX];
+    long long blocs[CANAL_ATTENTE_MAX];
+    int ordre[CANAL_ATTENTE_MAX];
+    int n_gardees = 0, emises = 0;
+    int i, j;
+
+    // Sort by level, keeping the capture block alongside
+    for (i = 0; i < c->n_attente; i++) ordre[i] = i;
+    for (i = 1; i < c->n_attente; i++) {
+        int o = ordre[i];
+        for (j = i; j > 0 && compare_niveaux(&c->attente[ordre[j - 1]], &c->attente[o]) > 0; j--) {
+            ordre[j] = ordre[j - 1];
+        }
+        ordre[j] = o;
+    }
+
+    for (i = 0; i < c->n_attente; i++) {
+        TrameCanal *t = &c->attente[ordre[i]];
+        int doublon = 0;
+
+        for (j = 0; j < c->n_recentes && !doublon; j++) {
+            doublon = meme_salve(c, t, &c->recentes[j]);
+        }
+        for (j = 0; j < n_gardees && !doublon; j++) {
+            doublon = meme_salve(c, t, &gardees[j]);
+        }
+        if (doublon) continue;
+
+        if (c->bloc_attente[ordre[i]] < avant) {
+            c->recentes[c->pos_recentes] = *t;
+            c->pos_recentes = (c->pos_recentes + 1) % CANAL_RECENTES;
+            if (c->n_recentes < CANAL_RECENTES) c->n_recentes++;
+            c->cb(t, c->utilisateur);
+            emises++;
+        } else {
+            blocs[n_gardees] = c->bloc_attente[ordre[i]];
+            gardees[n_gardees++] = *t;
+        }
+    }
+
+    memcpy(c->attente, gardees, n_gardees * sizeof(TrameCanal));
+    memcpy(c->bloc_attente, blocs, n_gardees * sizeof(long long));
+    c->n_attente = n_gardees;
+    return emises;
+}
+
+// ===================================================
+// Creation
+// ===================================================
+static int puissance2(double x) {
+    int n = 1;
+    while (n < x) n <<= 1;
+    return n;
+}
+
+static int compare_doubles(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+Canaliseur *canaliseur_cree(FormatIQ format, int f_iq, double f_centre,
+                            const DemodConfig *modele, canal_trame_cb cb,
+                            void *utilisateur) {
+    Canaliseur *c;
+    DemodConfig cfg;
+    double bin, fc, somme = 0.0;
+    double *h;
+    int P, i, k;
+
+    if (format == IQ_AUCUN || f_iq <= 0) return NULL;
+    c = calloc(1, sizeof(*c));
+    if (!c) return NULL;
+    c->format = format;
+    c->f_iq = f_iq;
+    c->f_centre = f_centre;
+    c->cb = cb;
+    c->utilisateur = utilisateur;
+
+    // The N/4 overlap bounds the filter length, hence its transition
+    c->N = puissance2(4.0 * 5.5 * f_iq / (CANAL_ARRET - CANAL_BANDE));
+    bin = (double)f_iq / c->N;
+    c->K = puissance2(3.0 * CANAL_ARRET / bin);
+    if (c->K < 8) c->K = 8;
+    if (c->K > c->N) c->K = c->N;
+    c->L = c->N - c->N / 4;
+    c->demi_bande = (int)(CANAL_ESPACEMENT / 2.0 / bin);
+    c->seuil = pow(10.0, CANAL_SEUIL_DB / 10.0);
+    c->maintien = (int)ceil(CANAL_MAINTIEN_S * f_iq / c->L);
+
+    // Channels whose filter fits inside the input band
+    for (i = 0; i < N_CANAUX_T012; i++) {
+        double f = CANAL_PREMIER + i * CANAL_ESPACEMENT;
+        double df = f - f_centre;
+        if (fabs(df) + CANAL_ARRET > 0.45 * f_iq) continue;
+        k = (int)lround(df / bin);
+        c->canaux[c->n_canaux].index = i;
+        c->canaux[c->n_canaux].f = f;
+        c->canaux[c->n_canaux].k0 = (k + c->N) % c->N;
+        c->n_canaux++;
+    }
+    if (c->n_canaux == 0) {
+        fprintf(stderr, "No T.012 channel within %.3f MHz +/- %.0f kHz\n",
+                f_centre / 1e6, 0.45 * f_iq / 1e3);
+        free(c);
+        return NULL;
+    }
+
+    c->x_re = calloc(c->N, sizeof(float));
+    c->x_im = calloc(c->N, sizeof(float));
+    c->X_re = malloc(c->N * sizeof(float));
+    c->X_im = malloc(c->N * sizeof(float));
+    c->y_re = malloc(c->N * sizeof(float));
+    c->y_im = malloc(c->N * sizeof(float));
+    c->H_re = malloc(c->K * sizeof(float));
+    c->H_im = malloc(c->K * sizeof(float));
+    c->sortie = malloc(c->K * sizeof(short));
+    c->energies = malloc(c->n_canaux * sizeof(double));
+    h = calloc(c->N, sizeof(double));
+    if (!c->x_re || !c->x_im || !c->X_re || !c->X_im || !c->y_re || !c->y_im ||
+        !c->H_re || !c->H_im || !c->sortie || !c->energies || !h ||
+        fft_init(&c->grand, c->N) != 0 || fft_init(&c->petit, c->K) != 0) {
+        fprintf(stderr, "Memory allocation error\n");
+        free(h);
+        canaliseur_detruit(c);
+        return NULL;
+    }
+
+    // Blackman-windowed sinc over the N/4 + 1 taps the overlap allows,
+    // normalized so that a channel sample has the input's full scale
+    P = c->N / 4 + 1;
+    fc = (CANAL_BANDE + CANAL_ARRET) / 2.0 / f_iq;
+    for (i = 0; i < P; i++) {
+        double t = i - (P - 1) / 2.0;
+        double sinc = (t == 0.0) ? 2.0 * fc : sin(2.0 * M_PI * fc * t) / (M_PI * t);
+        double w = 0.42 - 0.5 * cos(2.0 * M_PI * i / (P - 1)) +
+                   0.08 * cos(4.0 * M_PI * i / (P - 1));
+        h[i] = sinc * w;
+        somme += h[i];
+    }
+    for (i = 0; i < P; i++) {
+        c->X_re[i] = (float)(h[i] / somme / c->N);
+        c->X_im[i] = 0.0f;
+    }
+    for (; i < c->N; i++) {
+        c->X_re[i] = 0.0f;
+        c->X_im[i] = 0.0f;
+    }
+    free(h);
+    fft_calcule(&c->grand, c->X_re, c->X_im, 0);
+    // Causal taps: the first P-1 outputs of a block are wrapped around,
+    // which is why only the last 3/4 of each inverse FFT are kept
+    for (i = 0; i < c->K; i++) {
+        int b = (i < c->K / 2) ? i : c->N - c->K + i;
+        c->H_re[i] = c->X_re[b];
+        c->H_im[i] = c->X_im[b];
+    }
+
+    // One decoder per channel
+    cfg = *modele;
+    cfg.f_ech = (int)((double)f_iq * c->K / c->N);
+    cfg.verbeux = 0;
+    for (i = 0; i < c->n_canaux; i++) {
+        Canal *k0 = &c->canaux[i];
+        k0->demod = demod_cree(&cfg, trame_canal, c);
+        if (!k0->demod || phase_iq_init(&k0->phase, cfg.f_ech, c->K) != 0) {
+            canaliseur_detruit(c);
+            return NULL;
+        }
+    }
+    return c;
+}
+
+void canaliseur_detruit(Canaliseur *c) {
+    int i;
+
+    if (!c) return;
+    for (i = 0; i < c->n_canaux; i++) {
+        demod_detruit(c->canaux[i].demod);
+        phase_iq_libere(&c->canaux[i].phase);
+    }
+    fft_libere(&c->grand);
+    fft_libere(&c->petit);
+    free(c->x_re);
+    free(c->x_im);
+    free(c->X_re);
+    free(c->X_im);
+    free(c->y_re);
+    free(c->y_im);
+    free(c->H_re);
+    free(c->H_im);
+    free(c->sortie);
+    free(c->energies);
+    free(c);
+}
+
+// ===================================================
+// Block processing
+// ===================================================
+static double energie_canal(const Canaliseur *c, const Canal *k) {
+    double e = 0.0;
+    int b;
+
+    for (b = -c->demi_bande; b <= c->demi_bande; b++) {
+        int j = (k->k0 + b + c->N) % c->N;
+        e += (double)c->X_re[j] * c->X_re[j] + (double)c->X_im[j] * c->X_im[j];
+    }
+    return e;
+}
+
+// Bring channel k back to baseband and feed its decoder
+static void demodule_canal(Canaliseur *c, Canal *k) {
+    const int K = c->K;
+    const int N = c->N;
+    const int n_sortie = K - K / 4;
+    float cr, ci;
+    int i, quart;
+
+    for (i = 0; i < K; i++) {
+        int b = (i < K / 2) ? i : i - K;
+        int j = (k->k0 + b + N) % N;
+        c->y_re[i] = c->X_re[j] * c->H_re[i] - c->X_im[j] * c->H_im[i];
+        c->y_im[i] = c->X_re[j] * c->H_im[i] + c->X_im[j] * c->H_re[i];
+    }
+    fft_calcule(&c->petit, c->y_re, c->y_im, 1);
+
+    // Block b starts at input sample b*L = b*3N/4: the mix to baseband
+    // is off by exp(-2*pi*i*k0*b*3/4), a whole number of quarter turns
+    quart = (int)((3LL * k->k0 % 4) * (c->n_blocs % 4) % 4);
+    cr = (quart == 0) ? 1.0f : (quart == 2) ? -1.0f : 0.0f;
+    ci = (quart == 1) ? -1.0f : (quart == 3) ? 1.0f : 0.0f;
+    for (i = 0; i < n_sortie; i++) {
+        float re = c->y_re[K / 4 + i], im = c->y_im[K / 4 + i];
+        c->y_re[i] = re * cr - im * ci;
+        c->y_im[i] = re * ci + im * cr;
+    }
+
+    phase_iq_bloc(&k->phase, c->y_re, c->y_im, n_sortie, c->sortie);
+    c->courant = k;
+    demod_alimente(k->demod, c->sortie, n_sortie);
+}
+
+static void traite_bloc(Canaliseur *c) {
+    const int n_sortie = c->K - c->K / 4;
+    double mediane;
+    int i;
+
+    memcpy(c->X_re, c->x_re, c->N * sizeof(float));
+    memcpy(c->X_im, c->x_im, c->N * sizeof(float));
+    fft_calcule(&c->grand, c->X_re, c->X_im, 0);
+
+    // Noise floor: median energy over the channels, most of them idle
+    for (i = 0; i < c->n_canaux; i++) {
+        c->energies[i] = energie_canal(c, &c->canaux[i]);
+    }
+    {
+        double tri[N_CANAUX_T012];
+        memcpy(tri, c->energies, c->n_canaux * sizeof(double));
+        qsort(tri, c->n_canaux, sizeof(double), compare_doubles);
+        mediane = tri[c->n_canaux / 2];
+    }
+
+    for (i = 0; i < c->n_canaux; i++) {
+        Canal *k = &c->canaux[i];
+        double rapport = (mediane > 0.0) ? c->energies[i] / mediane : 0.0;
+
+        if (rapport > c->seuil) {
+            if (k->maintien == 0) {
+                // Waking up: fresh carrier and thresholds, positions
+                // continue from the channel's sample clock
+                phase_iq_raz(&k->phase);
+                demod_reinit(k->demod);
+                k->base = c->n_blocs * n_sortie - demod_position(k->demod);
+                k->niveau = -99.0;
+            }
+            k->maintien = c->maintien;
+            if (10.0 * log10(rapport) > k->niveau) k->niveau = 10.0 * log10(rapport);
+        }
+        if (k->maintien > 0) {
+            demodule_canal(c, k);
+            // Going to sleep: frames the threshold bank holds go now
+            if (--k->maintien == 0) demod_vide(k->demod);
+        }
+    }
+
+    c->n_blocs++;
+    memmove(c->x_re, c->x_re + c->L, (c->N - c->L) * sizeof(float));
+    memmove(c->x_im, c->x_im + c->L, (c->N - c->L) * sizeof(float));
+    c->remplissage = 0;
+}
+
+int canaliseur_alimente(Canaliseur *c, const void *brut, int n) {
+    const unsigned char *p = brut;
+    const int octets = iq_octets(c->format);
+    const int debut = c->N - c->L;
+    int emises = 0;
+
+    while (n > 0) {
+        int m = c->L - c->remplissage;
+        if (m > n) m = n;
+        iq_convertit(c->format, p, m, c->x_re + debut + c->remplissage,
+                     c->x_im + debut + c->remplissage);
+        c->remplissage += m;
+        c->n_entree += m;
+        p += (size_t)m * octets;
+        n -= m;
+        if (c->remplissage == c->L) {
+            traite_bloc(c);
+            emises += emet_trames(c, c->n_blocs);
+        }
+    }
+    return emises;
+}
+
+int canaliseur_termine(Canaliseur *c) {
+    int i;
+
+    for (i = 0; i < c->n_canaux; i++) demod_vide(c->canaux[i].demod);
+    return emet_trames(c, c->n_blocs + 1);
+}
+
+void canaliseur_affiche(const Canaliseur *c) {
+    int i;
+
+    printf("Channelizer: %d-point FFT, %d channels at %.1f Hz (%d-point inverse)\n",
+           c->N, c->n_canaux, (double)c->f_iq * c->K / c->N, c->K);
+    printf("Channels:");
+    for (i = 0; i < c->n_canaux; i++) {
+        printf(" %c", 'A' + c->canaux[i].index);
+    }
+    printf(" (%.3f to %.3f MHz)\n", c->canaux[0].f / 1e6,
+           c->canaux[c->n_canaux - 1].f / 1e6);
+}
+
+long long canaliseur_position(const Canaliseur *c) {
+    return c->n_entree;
+}
+
+long long canaliseur_perdues(const Canaliseur *c) {
+    return c->n_perdues;
+}
@@ -0,0 +1,114 @@
+/**********************************
+
+## Licence
+
+ Licence Creative Commons CC BY-NC-SA 
+
+## Auteurs et contributions
+
+- **Code original dec406_v7** : F4EHY (2020)
+- **Refactoring et support 2G** : Développement collaboratif (2025)
+- **Conformité T.018** : Implémentation complète BCH + MID database
+
+***********************************/
+
+// channelizer.h - Wideband IQ split into the T.012 channels, one decoder each
+#ifndef CHANNELIZER_H
+#define CHANNELIZER_H
+
+#include "demod_1g.h"
+#include "iq_demod.h"
+
+// T.012 channel plan: A = 406.022 MHz to S = 406.076 MHz, 3 kHz apart
+#define CANAL_PREMIER 406022000.0
+#define CANAL_ESPACEMENT 3000.0
+#define N_CANAUX_T012 19
+
+// Channel filter: flat to CANAL_BANDE, stopband from CANAL_ARRET (Hz)
+#define CANAL_BANDE 1200.0
+#define CANAL_ARRET 2600.0
+
+// A channel wakes up CANAL_SEUIL_DB above the median channel energy
+// and keeps decoding CANAL_MAINTIEN_S after its energy drops
+#define CANAL_SEUIL_DB 6.0
+#define CANAL_MAINTIEN_S 1.0
+
+// ===================================================
+// Frame found on one channel
+// ===================================================
+typedef struct {
+    TrameDemod trame;   // Positions in input samples from stream start
+    int canal;          // Channel index, 0 for A
+    double f_canal;     // Channel frequency (Hz)
+    double niveau;      // Channel energy over the median, when captured (dB)
+} TrameCanal;
+
+/**
+ * Frame callback, called once per burst even if neighbouring channels
+ * decoded it too (the strongest one is kept)
+ * @param trame Frame, only valid during the call
+ * @param utilisateur Pointer given to canaliseur_cree()
+ */
+typedef void (*canal_trame_cb)(const TrameCanal *trame, void *utilisateur);
+
+typedef struct Canaliseur Canaliseur;
+
+/**
+ * Create a channelizer for the channels inside the input band
+ * @param format Raw sample format
+ * @param f_iq Input sample rate (Hz)
+ * @param f_centre Tuner centre frequency (Hz)
+ * @param modele Decoder settings; sample rate and messages are overridden
+ * @param cb Frame callback
+ * @param utilisateur Pointer passed back to cb
+ * @return New channelizer, NULL if no channel fits or on allocation error
+ */
+Canaliseur *canaliseur_cree(FormatIQ format, int f_iq, double f_centre,
+                            const DemodConfig *modele, canal_trame_cb cb,
+                            void *utilisateur);
+
+/**
+ * Free a channelizer
+ * @param c Channelizer from canaliseur_cree(), may be NULL
+ */
+void canaliseur_detruit(Canaliseur *c);
+
+/**
+ * Push raw IQ samples; frames found are passed to the callback
+ * Frames are held for one FFT block so that a burst seen on several
+ * channels is reported once
+ * @param c Channelizer
+ * @param brut Raw samples in the configured format
+ * @param n Number of complex samples
+ * @return Number of frames reported
+ */
+int canaliseur_alimente(Canaliseur *c, const void *brut, int n);
+
+/**
+ * Report the frames still held, at end of stream
+ * @param c Channelizer
+ * @return Number of frames reported
+ */
+int canaliseur_termine(Canaliseur *c);
+
+/**
+ * Describe the channel split on stdout (channels, FFT and output rates)
+ * @param c Channelizer
+ */
+void canaliseur_affiche(const Canaliseur *c);
+
+/**
+ * Input samples consumed since creation
+ * @param c Channelizer
+ * @return Sample count at the input rate
+ */
+long long canaliseur_position(const Canaliseur *c);
+
+/**
+ * Frames dropped because the hold buffer was full
+ * @param c Channelizer
+ * @return Frames decoded but never reported
+ */
+long long canaliseur_perdues(const Canaliseur *c);
+
+#endif // CHANNELIZER_H
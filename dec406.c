@@ -22,23 +22,24 @@
  * Main beacon decoding dispatcher
  * Routes to appropriate decoder based on frame length
  */
-void decode_beacon(const uint8_t *bits, int length) {
-    if (!bits) {
-        fprintf(stderr, "Error: NULL bits array\n");
+void decode_beacon(const Trame406 *trame) {
+    if (!trame) {
+        fprintf(stderr, "Error: NULL frame\n");
         return;
     }
     
+    const int length = trame->longueur;
     switch(length) {
         case FRAME_1G_SHORT:
         case FRAME_1G_LONG:
             printf("Starting 1G decoding (%s frame)...\n", 
                   (length == FRAME_1G_SHORT) ? "short" : "long");
-            decode_1g(bits, length);
+            decode_1g(trame);
             break;
             
         case FRAME_2G_LENGTH:
             printf("Starting 2G decoding...\n");
-            decode_2g(bits);
+            decode_2g(trame);
             break;
             
         default:
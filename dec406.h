@@ -18,13 +18,19 @@
 #define DEC406_H
 
 #include <stdint.h>
+#include "trame406.h"
 
 #define FRAME_1G_SHORT 112
 #define FRAME_1G_LONG 144
 #define FRAME_2G_LENGTH 250
 
-void decode_1g(const uint8_t *bits, int length);
-void decode_2g(const uint8_t *bits);
-void decode_beacon(const uint8_t *bits, int length);
+void decode_1g(const Trame406 *trame);
+void decode_2g(const Trame406 *trame);
+
+// Same, with per-bit reliabilities (0 weakest, 128 typical) from the
+// demodulator: frames past hard BCH correction get Chase decoding
+void decode_1g_soft(const Trame406 *trame, const uint8_t *fiabilite);
+void decode_2g_soft(const Trame406 *trame, const uint8_t *fiabilite);
+void decode_beacon(const Trame406 *trame);
 
 #endif
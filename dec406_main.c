@@ -20,118 +20,38 @@
 #include <string.h>
 #include <ctype.h>
 
-void hex_string_to_bits(const char* hex_str, uint8_t* bits, int bit_count) {
-    int hex_len = strlen(hex_str);
-    int data_bits = hex_len * 4;
+// Fill a frame of bit_count bits from a cleaned hex string
+void hex_string_to_frame(const char* hex_str, Trame406 *trame, int bit_count) {
+    int data_bits = strlen(hex_str) * 4;
     
-    // Check if we need to add sync pattern (15 bits of '1' + 9 bits frame sync)
-    int needs_sync = 0;
-    int sync_offset = 0;
+    trame406_efface(trame, bit_count);
     
-    if (bit_count == FRAME_1G_SHORT || bit_count == FRAME_1G_LONG) {
-        // For 1G frames, check if hex corresponds to data without sync
-        if ((bit_count == FRAME_1G_SHORT && data_bits == (FRAME_1G_SHORT - 24)) ||  // 112-24=88 bits
-            (bit_count == FRAME_1G_LONG && data_bits == (FRAME_1G_LONG - 24))) {   // 144-24=120 bits
-            needs_sync = 1;
-            sync_offset = 24; // 15 bits sync + 9 bits frame sync
-            printf("Detected hex data without sync pattern - adding sync bits\n");
-        }
-    }
-    
-    if (needs_sync) {
-        // Clear the entire bit array
-        memset(bits, 0, bit_count * sizeof(uint8_t));
-        
-        // Add 15 sync bits (all '1')
-        for (int i = 0; i < 15; i++) {
-            bits[i] = 1;
-        }
+    // Check if we need to add sync pattern (15 bits of '1' + 9 bits frame sync)
+    if ((bit_count == FRAME_1G_SHORT && data_bits == (FRAME_1G_SHORT - 24)) ||  // 112-24=88 bits
+        (bit_count == FRAME_1G_LONG && data_bits == (FRAME_1G_LONG - 24))) {   // 144-24=120 bits
+        printf("Detected hex data without sync pattern - adding sync bits\n");
         
-        // Add frame sync pattern (9 bits: 000101101)
-        bits[15] = 0; bits[16] = 0; bits[17] = 0;
-        bits[18] = 1; bits[19] = 0; bits[20] = 1;
-        bits[21] = 1; bits[22] = 0; bits[23] = 1;
+        // Add 15 sync bits (all '1') and frame sync pattern (9 bits: 000101101)
+        trame406_pose(trame, 0, 15, 0x7FFF);
+        trame406_pose(trame, 15, 9, 0x02D);
         
         // Convert hex data starting at bit 24
-        for (int i = 0; i < hex_len; i++) {
-            char c = tolower(hex_str[i]);
-            int value;
-            if (c >= 'a' && c <= 'f') {
-                value = c - 'a' + 10;
-            } else if (c >= '0' && c <= '9') {
-                value = c - '0';
-            } else {
-                value = 0;
-                fprintf(stderr, "Avertissement: caractère non hexadécimal '%c' à la position %d\n", c, i);
-            }
-            
-            int bit_pos = 24 + i * 4;
-            if (bit_pos + 3 < bit_count) {
-                bits[bit_pos]   = (value >> 3) & 1;
-                bits[bit_pos+1] = (value >> 2) & 1;
-                bits[bit_pos+2] = (value >> 1) & 1;
-                bits[bit_pos+3] = (value >> 0) & 1;
-            }
-        }
+        trame406_depuis_hex(trame, hex_str, 24);
+        return;
+    }
+    
+    if (data_bits < bit_count) {
+        fprintf(stderr, "Chaîne hexadécimale trop courte: %d bits < %d bits\n", data_bits, bit_count);
+        exit(EXIT_FAILURE);
+    }
+    
+    if (bit_count == FRAME_2G_LENGTH) {
+        // For 2G: expect 63 hex chars = 252 bits = 2 padding + 250 data
+        // Skip the first 2 padding bits
+        trame406_depuis_hex(trame, hex_str, -2);
+        printf("2G frame detected: skipped 2 padding bits, extracted %d data bits\n", bit_count);
     } else {
-        // Original behavior for complete frames
-        if (data_bits < bit_count) {
-            fprintf(stderr, "Chaîne hexadécimale trop courte: %d bits < %d bits\n", data_bits, bit_count);
-            exit(EXIT_FAILURE);
-        }
-
-        // Special handling for 2G frames with padding
-        if (bit_count == FRAME_2G_LENGTH) {
-            // For 2G: expect 63 hex chars = 252 bits = 2 padding + 250 data
-            // Skip the first 2 padding bits
-            int bit_offset = 0;
-            
-            for (int i = 0; i < hex_len; i++) {
-                char c = tolower(hex_str[i]);
-                int value;
-                if (c >= 'a' && c <= 'f') {
-                    value = c - 'a' + 10;
-                } else if (c >= '0' && c <= '9') {
-                    value = c - '0';
-                } else {
-                    value = 0;
-                    fprintf(stderr, "Avertissement: caractère non hexadécimal '%c' à la position %d\n", c, i);
-                }
-                
-                // Extract 4 bits from this hex digit
-                for (int j = 3; j >= 0; j--) {
-                    int bit_pos = i * 4 + (3 - j);
-                    int bit_val = (value >> j) & 1;
-                    
-                    // Skip first 2 padding bits, then store the next 250 bits
-                    if (bit_pos >= 2 && bit_offset < bit_count) {
-                        bits[bit_offset++] = bit_val;
-                    }
-                }
-            }
-            printf("2G frame detected: skipped 2 padding bits, extracted %d data bits\n", bit_offset);
-        } else {
-            // Original 1G handling
-            for (int i = 0; i < hex_len; i++) {
-                char c = tolower(hex_str[i]);
-                int value;
-                if (c >= 'a' && c <= 'f') {
-                    value = c - 'a' + 10;
-                } else if (c >= '0' && c <= '9') {
-                    value = c - '0';
-                } else {
-                    value = 0;
-                    fprintf(stderr, "Avertissement: caractère non hexadécimal '%c' à la position %d\n", c, i);
-                }
-                
-                if (i*4 + 3 < bit_count) {
-                    bits[i*4]   = (value >> 3) & 1;
-                    bits[i*4+1] = (value >> 2) & 1;
-                    bits[i*4+2] = (value >> 1) & 1;
-                    bits[i*4+3] = (value >> 0) & 1;
-                }
-            }
-        }
+        trame406_depuis_hex(trame, hex_str, 0);
     }
 }
 
@@ -181,16 +101,9 @@ int main(int argc, char *argv[]) {
         return EXIT_FAILURE;
     }
 
-    uint8_t* bits = malloc(bit_count * sizeof(uint8_t));
-    if (!bits) {
-        perror("Erreur d'allocation mémoire");
-        return EXIT_FAILURE;
-    }
-
-    memset(bits, 0, bit_count * sizeof(uint8_t));
-    hex_string_to_bits(cleaned_hex, bits, bit_count);
-    decode_beacon(bits, bit_count);
-    free(bits);
+    Trame406 trame;
+    hex_string_to_frame(cleaned_hex, &trame, bit_count);
+    decode_beacon(&trame);
 
     return EXIT_SUCCESS;
 }
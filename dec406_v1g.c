@@ -20,6 +20,8 @@
 #include <stdlib.h>
 #include "dec406.h"
 #include "display_utils.h"
+#include "trame406.h"
+#include "bch406.h"
 
 // ===================================================
 // Constants and structures
@@ -64,6 +66,8 @@ typedef struct {
     ProtocolType protocol;
     uint8_t frame_type;
     uint8_t crc_error;
+    uint8_t bits_corrected;  // Bit errors fixed by BCH-1 and BCH-2
+    uint8_t chase;           // Corrected by Chase decoding on soft decisions
     uint8_t activation_method;
     uint8_t location_freshness;
     // Fields for position offsets
@@ -77,110 +81,47 @@ typedef struct {
 } BeaconInfo1G;
 
 // Forward declarations for all decode functions
-static void decode_user_location(const char *s, BeaconInfo1G *info, int frame_length);
-static void decode_standard_location(const char *s, BeaconInfo1G *info, int frame_length);
-static void decode_national_location(const char *s, BeaconInfo1G *info, int frame_length);
-static void decode_elt_dt_location(const char *s, BeaconInfo1G *info);
-static void decode_rls_location(const char *s, BeaconInfo1G *info, int frame_length);
-static void decode_serial_user_protocol(const char *s, BeaconInfo1G *info);
-static void decode_user_identification(const char *frame, BeaconInfo1G *info);
-static void decode_aircraft_address(const char *s, BeaconInfo1G *info);
-static void decode_supplementary_data(const char *s, BeaconInfo1G *info);
-static void decode_orbitography_data(const char *bits, BeaconInfo1G *info);
-static void decode_standard_test_data(const char *bits, BeaconInfo1G *info);
-static void decode_test_beacon_data(const char *bits, BeaconInfo1G *info);
-static void decode_national_use_data(const char *bits, BeaconInfo1G *info);
-static void decode_radio_callsign_data(const char *bits, BeaconInfo1G *info);
-static void display_baudot_42(const char *bits);
-static void display_baudot_2(const char *bits);
-static void display_specific_beacon(const char *bits);
+static void decode_user_location(const Trame406 *s, BeaconInfo1G *info, int frame_length);
+static void decode_standard_location(const Trame406 *s, BeaconInfo1G *info, int frame_length);
+static void decode_national_location(const Trame406 *s, BeaconInfo1G *info, int frame_length);
+static void decode_elt_dt_location(const Trame406 *s, BeaconInfo1G *info);
+static void decode_rls_location(const Trame406 *s, BeaconInfo1G *info, int frame_length);
+static void decode_serial_user_protocol(const Trame406 *s, BeaconInfo1G *info);
+static void decode_user_identification(const Trame406 *frame, BeaconInfo1G *info);
+static void decode_aircraft_address(const Trame406 *s, BeaconInfo1G *info);
+static void decode_supplementary_data(const Trame406 *s, BeaconInfo1G *info);
+static void decode_orbitography_data(const Trame406 *bits, BeaconInfo1G *info);
+static void decode_standard_test_data(const Trame406 *bits, BeaconInfo1G *info);
+static void decode_test_beacon_data(const Trame406 *bits, BeaconInfo1G *info);
+static void decode_national_use_data(const Trame406 *bits, BeaconInfo1G *info);
+static void decode_radio_callsign_data(const Trame406 *bits, BeaconInfo1G *info);
+static void display_baudot_42(const Trame406 *bits);
+static void display_baudot_2(const Trame406 *bits);
+static void display_specific_beacon(const Trame406 *bits);
 static char decode_baudot_char(int x);
 static int validate_coordinates(double lat, double lon);
-static int validate_frame_sync(const char *frame, int frame_length);
-static void decode_1g_frame(const char *frame, int frame_length, BeaconInfo1G *info);
+static int validate_frame_sync(const Trame406 *frame, int frame_length);
+static void decode_1g_frame(Trame406 *frame, int frame_length, BeaconInfo1G *info,
+                            const uint8_t *fiabilite);
 
 // ===================================================
 // CRC validation functions
 // ===================================================
-static int test_crc1(const char *s) {
-    int g[] = {1,0,0,1,1,0,1,1,0,1,1,0,0,1,1,1,1,0,0,0,1,1};
-    int div[22];
-    int i, j, ss = 0;
-    int zero = 0;
-
-    for (i = 85; i < 106; i++) {
-        if (s[i] == '1') zero++;
-    }
-
-    i = 24;
-    for (j = 0; j < 22; j++) {
-        div[j] = (s[i+j] == '1') ? 1 : 0;
-    }
-
-    while (i < 85) {
-        for (j = 0; j < 22; j++) {
-            div[j] = div[j] ^ g[j];
-        }
-        while ((div[0] == 0) && (i < 85)) {
-            for (j = 0; j < 21; j++) {
-                div[j] = div[j+1];
-            }
-            if (i < 84) {
-                div[21] = (s[i+22] == '1') ? 1 : 0;
-            }
-            i++;
-        }
-    }
-
-    for (j = 0; j < 22; j++) ss += div[j];
-    return (ss == 0 || zero == 0) ? 0 : 1;
+// A check passes when the remainder is zero. BCH-1 is always sent, so a
+// zero BCH-1 field is no excuse: such a frame goes to correction like any
+// other. BCH-2 also passes when its field is all zeros, as sent on long
+// frames by beacons that leave the second protected field unused.
+static int test_crc1(const Trame406 *t) {
+    return (bch1_reste(t) == 0) ? 0 : 1;
 }
 
-static int test_crc2(const char *s) {
-    int g[] = {1,0,1,0,1,0,0,1,1,1,0,0,1};
-    int div[13];
-    int i, j, ss = 0;
-    int zero = 0;
-
-    for (i = 132; i < 144; i++) {
-        if (s[i] == '1') zero++;
-    }
-
-    i = 106;
-    for (j = 0; j < 13; j++) {
-        div[j] = (s[i+j] == '1') ? 1 : 0;
-    }
-
-    while (i < 132) {
-        for (j = 0; j < 13; j++) {
-            div[j] = div[j] ^ g[j];
-        }
-        while ((div[0] == 0) && (i < 132)) {
-            for (j = 0; j < 12; j++) {
-                div[j] = div[j+1];
-            }
-            if (i < 131) {
-                div[12] = (s[i+13] == '1') ? 1 : 0;
-            }
-            i++;
-        }
-    }
-
-    for (j = 0; j < 13; j++) ss += div[j];
-    return (ss == 0 || zero == 0) ? 0 : 1;
+static int test_crc2(const Trame406 *t) {
+    return (bch2_reste(t) == 0 || trame406_champ(t, 132, 12) == 0) ? 0 : 1;
 }
 
 // ===================================================
 // Utility functions
 // ===================================================
-static uint32_t get_bits(const char *s, int start, int len) {
-    uint32_t val = 0;
-    for (int i = 0; i < len; i++) {
-        val = (val << 1) | (s[start + i] == '1' ? 1 : 0);
-    }
-    return val;
-}
-
 static int validate_coordinates(double lat, double lon) {
     return (lat >= -90.0 && lat <= 90.0 && lon >= -180.0 && lon <= 180.0);
 }
@@ -188,16 +129,16 @@ static int validate_coordinates(double lat, double lon) {
 // ===================================================
 // ELT-DT Location Protocol decoder (Protocol 9) - T.001 Specification
 // ===================================================
-static void decode_elt_dt_location(const char *s, BeaconInfo1G *info) {
+static void decode_elt_dt_location(const Trame406 *s, BeaconInfo1G *info) {
     if (info->frame_type == LONG_FRAME_BITS) {
         // Decode base position (PDF-1)
-        uint8_t ns_flag = (s[66] == '1');  // Bit 67 (index 66) - N/S flag
-        uint8_t lat_val = get_bits(s, 67, 8);  // Bits 68-75 (indices 67-74) - Latitude value
+        uint8_t ns_flag = trame406_bit(s, 66);  // Bit 67 (index 66) - N/S flag
+        uint8_t lat_val = trame406_champ(s, 67, 8);  // Bits 68-75 (indices 67-74) - Latitude value
         info->base_lat = lat_val * 0.5;  // 0.5° resolution
         if (ns_flag) info->base_lat = -info->base_lat;  // Apply South sign
 
-        uint8_t ew_flag = (s[75] == '1');  // Bit 76 (index 75) - E/W flag
-        uint16_t lon_val = get_bits(s, 76, 9);  // Bits 77-85 (indices 76-84) - Longitude value
+        uint8_t ew_flag = trame406_bit(s, 75);  // Bit 76 (index 75) - E/W flag
+        uint16_t lon_val = trame406_champ(s, 76, 9);  // Bits 77-85 (indices 76-84) - Longitude value
         info->base_lon = lon_val * 0.5;  // 0.5° resolution
         if (ew_flag) info->base_lon = -info->base_lon;  // Apply West sign
 
@@ -206,20 +147,20 @@ static void decode_elt_dt_location(const char *s, BeaconInfo1G *info) {
         info->lon = info->base_lon;
 
         // Activation method (bits 107-108)
-        info->activation_method = get_bits(s, 106, 2);
+        info->activation_method = trame406_champ(s, 106, 2);
         
         // Altitude (bits 109-112)
-        info->auxiliary_device = get_bits(s, 108, 4);
+        info->auxiliary_device = trame406_champ(s, 108, 4);
         
         // Location freshness (bits 113-114)
-        info->location_freshness = get_bits(s, 112, 2);
+        info->location_freshness = trame406_champ(s, 112, 2);
         
         // Apply position offsets if available
         if (info->location_freshness > 0) {
             // Latitude offset (bits 115-123 selon spec = indices 114-122 dans le tableau)
-            info->lat_offset_sign = (s[114] == '1') ? 1 : -1;  // Bit 115 -> index 114
-            info->lat_offset_min = get_bits(s, 115, 4);  // Bits 116-119 -> indices 115-118
-            info->lat_offset_sec = get_bits(s, 119, 4) * 4;  // Bits 120-123 -> indices 119-122
+            info->lat_offset_sign = trame406_bit(s, 114) ? 1 : -1;  // Bit 115 -> index 114
+            info->lat_offset_min = trame406_champ(s, 115, 4);  // Bits 116-119 -> indices 115-118
+            info->lat_offset_sec = trame406_champ(s, 119, 4) * 4;  // Bits 120-123 -> indices 119-122
     
             // Convert offset to degrees
             double lat_offset = info->lat_offset_sign * 
@@ -227,9 +168,9 @@ static void decode_elt_dt_location(const char *s, BeaconInfo1G *info) {
             info->lat += lat_offset;
     
             // Longitude offset (bits 124-132 selon spec = indices 123-131 dans le tableau)
-            info->lon_offset_sign = (s[123] == '1') ? 1 : -1;  // Bit 124 -> index 123
-            info->lon_offset_min = get_bits(s, 124, 4);  // Bits 125-128 -> indices 124-127
-            info->lon_offset_sec = get_bits(s, 128, 4) * 4;  // Bits 129-132 -> indices 128-131
+            info->lon_offset_sign = trame406_bit(s, 123) ? 1 : -1;  // Bit 124 -> index 123
+            info->lon_offset_min = trame406_champ(s, 124, 4);  // Bits 125-128 -> indices 124-127
+            info->lon_offset_sec = trame406_champ(s, 128, 4) * 4;  // Bits 129-132 -> indices 128-131
     
             // Convert offset to degrees
             double lon_offset = info->lon_offset_sign * 
@@ -238,11 +179,11 @@ static void decode_elt_dt_location(const char *s, BeaconInfo1G *info) {
         }
     } else {
         // Short frame handling
-        int lat_raw = get_bits(s, 67, 8);
+        int lat_raw = trame406_champ(s, 67, 8);
         info->lat = lat_raw / 2.0;
         info->base_lat = info->lat;
         
-        int lon_raw = get_bits(s, 75, 9);
+        int lon_raw = trame406_champ(s, 75, 9);
         info->lon = lon_raw / 2.0;
         info->base_lon = info->lon;
     }
@@ -260,13 +201,13 @@ static void decode_elt_dt_location(const char *s, BeaconInfo1G *info) {
 // ===================================================
 // Standard Location Protocol decoder (A3.3.5)
 // ===================================================
-static void decode_standard_location(const char *s, BeaconInfo1G *info, int frame_length) {
+static void decode_standard_location(const Trame406 *s, BeaconInfo1G *info, int frame_length) {
     // Store the protocol type
     info->protocol = PROTOCOL_STANDARD_LOCATION;
     info->has_position = 1;
 
     // Decode identification data (bits 41-64)
-    uint32_t id_data = get_bits(s, 40, 24); // bits 41-64 (indices 40-63)
+    uint32_t id_data = trame406_champ(s, 40, 24); // bits 41-64 (indices 40-63)
     
     // Decode based on protocol code (bits 37-40)
     switch (info->protocol_bits) {
@@ -315,14 +256,14 @@ static void decode_standard_location(const char *s, BeaconInfo1G *info, int fram
 
     // Decode base position from PDF-1 (bits 65-85)
     // Latitude (bits 65-74)
-    int ns_flag = (s[64] == '1'); // Bit 65: N/S flag (N=0, S=1)
-    int lat_quarters = get_bits(s, 65, 9); // Bits 66-74: degrees in 1/4 degree increments
+    int ns_flag = trame406_bit(s, 64); // Bit 65: N/S flag (N=0, S=1)
+    int lat_quarters = trame406_champ(s, 65, 9); // Bits 66-74: degrees in 1/4 degree increments
     info->base_lat = lat_quarters * 0.25; // Convert to degrees
     if (ns_flag) info->base_lat = -info->base_lat; // Apply South sign
     
     // Longitude (bits 75-85)
-    int ew_flag = (s[74] == '1'); // Bit 75: E/W flag (E=0, W=1)
-    int lon_quarters = get_bits(s, 75, 10); // Bits 76-85: degrees in 1/4 degree increments
+    int ew_flag = trame406_bit(s, 74); // Bit 75: E/W flag (E=0, W=1)
+    int lon_quarters = trame406_champ(s, 75, 10); // Bits 76-85: degrees in 1/4 degree increments
     info->base_lon = lon_quarters * 0.25; // Convert to degrees
     if (ew_flag) info->base_lon = -info->base_lon; // Apply West sign
     
@@ -341,26 +282,26 @@ static void decode_standard_location(const char *s, BeaconInfo1G *info, int fram
     // For long frames, decode PDF-2 offsets
     if (frame_length == LONG_FRAME_BITS) {
         // Check fixed bits (bits 107-110 should be "1101")
-        int fixed_bits = get_bits(s, 106, 4);
+        int fixed_bits = trame406_champ(s, 106, 4);
         if (fixed_bits != 0b1101) {
             printf("Warning: Invalid fixed bits in PDF-2: %04b\n", fixed_bits);
         }
         
         // Position data source (bit 111)
-        info->position_source = (s[110] == '1') ? 1 : 0; // 1=internal, 0=external
+        info->position_source = trame406_bit(s, 110); // 1=internal, 0=external
         
         // 121.5 MHz homing device (bit 112)
-        info->homing_flag = (s[111] == '1') ? 1 : 0;
+        info->homing_flag = trame406_bit(s, 111);
         
         // Δ latitude (bits 113-122)
-        info->lat_offset_sign = (s[112] == '1') ? 1 : -1; // Bit 113: sign (0=minus, 1=plus)
-        info->lat_offset_min = get_bits(s, 113, 5); // Bits 114-118: minutes (0-30)
-        info->lat_offset_sec = get_bits(s, 118, 4) * 4; // Bits 119-122: seconds in 4-second increments
+        info->lat_offset_sign = trame406_bit(s, 112) ? 1 : -1; // Bit 113: sign (0=minus, 1=plus)
+        info->lat_offset_min = trame406_champ(s, 113, 5); // Bits 114-118: minutes (0-30)
+        info->lat_offset_sec = trame406_champ(s, 118, 4) * 4; // Bits 119-122: seconds in 4-second increments
         
         // Δ longitude (bits 123-132)
-        info->lon_offset_sign = (s[122] == '1') ? 1 : -1; // Bit 123: sign (0=minus, 1=plus)
-        info->lon_offset_min = get_bits(s, 123, 5); // Bits 124-128: minutes (0-30)
-        info->lon_offset_sec = get_bits(s, 128, 4) * 4; // Bits 129-132: seconds in 4-second increments
+        info->lon_offset_sign = trame406_bit(s, 122) ? 1 : -1; // Bit 123: sign (0=minus, 1=plus)
+        info->lon_offset_min = trame406_champ(s, 123, 5); // Bits 124-128: minutes (0-30)
+        info->lon_offset_sec = trame406_champ(s, 128, 4) * 4; // Bits 129-132: seconds in 4-second increments
         
         // Apply offsets to calculate composite position
         double lat_offset = info->lat_offset_sign * 
@@ -391,31 +332,31 @@ static void decode_standard_location(const char *s, BeaconInfo1G *info, int fram
 // User Location Protocol decoder
 // ===================================================
 // Main function to decode User-Location position data
-static void decode_user_location(const char *s, BeaconInfo1G *info, int frame_length) {
+static void decode_user_location(const Trame406 *s, BeaconInfo1G *info, int frame_length) {
     if (frame_length == LONG_FRAME_BITS) {
         // For User-Location Protocol with long message, decode position from PDF-2
         // According to C/S T.001 section A3.2
         
         // Bit 107: Position source (0=external, 1=internal navigation device)
-        info->position_source = (s[106] == '1') ? 1 : 0;
+        info->position_source = trame406_bit(s, 106);
         
         // Bit 108: N/S flag (N=0, S=1)
-        int lat_sign = (s[107] == '0') ? 1 : -1;  // Bit 108 (index 107)
+        int lat_sign = trame406_bit(s, 107) ? -1 : 1;  // Bit 108 (index 107)
         
         // Bits 109-115: Latitude degrees (0-90) - 7 bits
-        int lat_deg = get_bits(s, 108, 7);  // Bits 109-115 (indices 108-114)
+        int lat_deg = trame406_champ(s, 108, 7);  // Bits 109-115 (indices 108-114)
         
         // Bits 116-119: Latitude minutes/4 (0-14, representing 0-56 minutes in 4-minute steps) - 4 bits
-        int lat_min_div4 = get_bits(s, 115, 4); // Bits 116-119 (indices 115-118)
+        int lat_min_div4 = trame406_champ(s, 115, 4); // Bits 116-119 (indices 115-118)
         
         // Bit 120: E/W flag (E=0, W=1)
-        int lon_sign = (s[119] == '0') ? 1 : -1;  // Bit 120 (index 119)
+        int lon_sign = trame406_bit(s, 119) ? -1 : 1;  // Bit 120 (index 119)
         
         // Bits 121-128: Longitude degrees (0-180) - 8 bits
-        int lon_deg = get_bits(s, 120, 8);  // Bits 121-128 (indices 120-127)
+        int lon_deg = trame406_champ(s, 120, 8);  // Bits 121-128 (indices 120-127)
         
         // Bits 129-132: Longitude minutes/4 (0-14, representing 0-56 minutes in 4-minute steps) - 4 bits
-        int lon_min_div4 = get_bits(s, 128, 4); // Bits 129-132 (indices 128-131)
+        int lon_min_div4 = trame406_champ(s, 128, 4); // Bits 129-132 (indices 128-131)
         
         // Calculate actual position
         // The minutes value is in 4-minute increments, so multiply by 4
@@ -450,9 +391,9 @@ static void decode_user_location(const char *s, BeaconInfo1G *info, int frame_le
 
 // Function to decode Serial User Protocol identification
 // For protocol code 011 (Serial User)
-static void decode_serial_user_protocol(const char *s, BeaconInfo1G *info) {
+static void decode_serial_user_protocol(const Trame406 *s, BeaconInfo1G *info) {
     // Get the 3-bit protocol code (bits 37-39)
-    int protocol_code = get_bits(s, 36, 3);
+    int protocol_code = trame406_champ(s, 36, 3);
     
     if (protocol_code != 0b011) {
         // Not a serial user protocol
@@ -460,19 +401,19 @@ static void decode_serial_user_protocol(const char *s, BeaconInfo1G *info) {
     }
     
     // Bits 40-42: Beacon type
-    int beacon_type = get_bits(s, 39, 3);  // Bits 40-42 (indices 39-41)
+    int beacon_type = trame406_champ(s, 39, 3);  // Bits 40-42 (indices 39-41)
     
     // Bit 43: C/S Type Approval Certificate flag
-    int cs_flag = (s[42] == '1') ? 1 : 0;  // Bit 43 (index 42)
+    int cs_flag = trame406_bit(s, 42);  // Bit 43 (index 42)
     
     // Bits 44-63: Serial number (20 bits)
-    uint32_t serial_number = get_bits(s, 43, 20);  // Bits 44-63 (indices 43-62)
+    uint32_t serial_number = trame406_champ(s, 43, 20);  // Bits 44-63 (indices 43-62)
     
     // Bits 64-73: All 0s or national use (10 bits)
-    uint32_t national_use = get_bits(s, 63, 10);  // Bits 64-73 (indices 63-72)
+    uint32_t national_use = trame406_champ(s, 63, 10);  // Bits 64-73 (indices 63-72)
     
     // Bits 74-83: C/S certificate number or national use (10 bits)
-    uint32_t cs_cert_number = get_bits(s, 73, 10);  // Bits 74-83 (indices 73-82)
+    uint32_t cs_cert_number = trame406_champ(s, 73, 10);  // Bits 74-83 (indices 73-82)
     
     // Build identification string based on beacon type
     const char *beacon_type_str;
@@ -524,9 +465,9 @@ static void decode_serial_user_protocol(const char *s, BeaconInfo1G *info) {
 }
 
 // Function to decode user identification for User and User-Location protocols
-static void decode_user_identification(const char *frame, BeaconInfo1G *info) {
+static void decode_user_identification(const Trame406 *frame, BeaconInfo1G *info) {
     // Get the user protocol code (bits 37-39)
-    int user_protocol_code = get_bits(frame, 36, 3);
+    int user_protocol_code = trame406_champ(frame, 36, 3);
     
     switch (user_protocol_code) {
         case 0b000:  // Orbitography Protocol
@@ -566,10 +507,10 @@ static void decode_user_identification(const char *frame, BeaconInfo1G *info) {
 // ===================================================
 // National Location Protocol decoder
 // ===================================================
-static void decode_national_location(const char *s, BeaconInfo1G *info, int frame_length) {
+static void decode_national_location(const Trame406 *s, BeaconInfo1G *info, int frame_length) {
     // Decode National ID (bits 41-58 = 18 bits)
     // These are indices 40-57 in the 0-indexed array
-    uint32_t national_id = get_bits(s, 40, 18);
+    uint32_t national_id = trame406_champ(s, 40, 18);
     
     // Determine beacon type based on protocol code
     const char *beacon_type_str;
@@ -599,14 +540,14 @@ static void decode_national_location(const char *s, BeaconInfo1G *info, int fram
     
     // PDF-1: Base position with 2-minute resolution
     // Bits 59-71: Latitude (13 bits)
-    int ns_flag = (s[58] == '1');  // Bit 59: N/S flag (N=0, S=1)
-    int lat_deg = get_bits(s, 59, 7);  // Bits 60-66: degrees (0-90)
-    int lat_min = get_bits(s, 66, 5) * 2;  // Bits 67-71: minutes (0-58) in 2-min increments
+    int ns_flag = trame406_bit(s, 58);  // Bit 59: N/S flag (N=0, S=1)
+    int lat_deg = trame406_champ(s, 59, 7);  // Bits 60-66: degrees (0-90)
+    int lat_min = trame406_champ(s, 66, 5) * 2;  // Bits 67-71: minutes (0-58) in 2-min increments
     
     // Bits 72-85: Longitude (14 bits)
-    int ew_flag = (s[71] == '1');  // Bit 72: E/W flag (E=0, W=1)
-    int lon_deg = get_bits(s, 72, 8);  // Bits 73-80: degrees (0-180)
-    int lon_min = get_bits(s, 80, 5) * 2;  // Bits 81-85: minutes (0-58) in 2-min increments
+    int ew_flag = trame406_bit(s, 71);  // Bit 72: E/W flag (E=0, W=1)
+    int lon_deg = trame406_champ(s, 72, 8);  // Bits 73-80: degrees (0-180)
+    int lon_min = trame406_champ(s, 80, 5) * 2;  // Bits 81-85: minutes (0-58) in 2-min increments
     
     // Calculate and store base position
     info->base_lat = lat_deg + lat_min / 60.0;
@@ -630,24 +571,24 @@ static void decode_national_location(const char *s, BeaconInfo1G *info, int fram
     // PDF-2: Position offsets (if long frame and bit 110 = 1)
     if (frame_length == LONG_FRAME_BITS) {
         // Check if position offset data is present (bit 110)
-        int additional_data_flag = (s[109] == '1');  // Bit 110: 1 = position offset data
+        int additional_data_flag = trame406_bit(s, 109);  // Bit 110: 1 = position offset data
         
         if (additional_data_flag) {
             // Store position data source (bit 111)
-            info->position_source = (s[110] == '1') ? 1 : 0;  // 1=internal, 0=external
+            info->position_source = trame406_bit(s, 110);  // 1=internal, 0=external
             
             // Store 121.5 MHz homing device flag (bit 112)
-            info->homing_flag = (s[111] == '1') ? 1 : 0;
+            info->homing_flag = trame406_bit(s, 111);
             
             // Latitude offset (bits 113-119 in doc = indices 112-118 in code)
-            info->lat_offset_sign = (s[112] == '1') ? 1 : -1;  // Bit 113 (index 112): sign
-            info->lat_offset_min = get_bits(s, 113, 2);  // Bits 114-115: minutes (0-3)
-            info->lat_offset_sec = get_bits(s, 115, 4) * 4;  // Bits 116-119: seconds in 4-sec increments
+            info->lat_offset_sign = trame406_bit(s, 112) ? 1 : -1;  // Bit 113 (index 112): sign
+            info->lat_offset_min = trame406_champ(s, 113, 2);  // Bits 114-115: minutes (0-3)
+            info->lat_offset_sec = trame406_champ(s, 115, 4) * 4;  // Bits 116-119: seconds in 4-sec increments
             
             // Longitude offset (bits 120-126 in doc = indices 119-125 in code)
-            info->lon_offset_sign = (s[119] == '1') ? 1 : -1;  // Bit 120 (index 119): sign
-            info->lon_offset_min = get_bits(s, 120, 2);  // Bits 121-122: minutes (0-3)
-            info->lon_offset_sec = get_bits(s, 122, 4) * 4;  // Bits 123-126: seconds in 4-sec increments
+            info->lon_offset_sign = trame406_bit(s, 119) ? 1 : -1;  // Bit 120 (index 119): sign
+            info->lon_offset_min = trame406_champ(s, 120, 2);  // Bits 121-122: minutes (0-3)
+            info->lon_offset_sec = trame406_champ(s, 122, 4) * 4;  // Bits 123-126: seconds in 4-sec increments
             
             // Apply offsets to calculate composite position
             double lat_offset = info->lat_offset_sign * 
@@ -661,7 +602,7 @@ static void decode_national_location(const char *s, BeaconInfo1G *info, int fram
         
         // Decode national use bits (127-132) if needed
         // These 6 bits are reserved for national use (additional beacon type identification or other)
-        // uint8_t national_use = get_bits(s, 126, 6);  // Bits 127-132 (indices 126-131)
+        // uint8_t national_use = trame406_champ(s, 126, 6);  // Bits 127-132 (indices 126-131)
         // Could be used for additional beacon identification if needed
     }
     
@@ -676,24 +617,24 @@ static void decode_national_location(const char *s, BeaconInfo1G *info, int fram
 // ===================================================
 // RLS Location Protocol decoder
 // ===================================================
-static void decode_rls_location(const char *s, BeaconInfo1G *info, int frame_length) {
+static void decode_rls_location(const Trame406 *s, BeaconInfo1G *info, int frame_length) {
     // RLS Location Protocol structure (bits selon T.001)
     // Bits 41-42: Beacon type (00=ELT, 01=EPIRB, 10=PLB, 11=Test)
-    uint8_t beacon_type = get_bits(s, 40, 2);
+    uint8_t beacon_type = trame406_champ(s, 40, 2);
     
     // Bits 43-46: Check if MMSI encoded (1111) or TAC/National RLS
-    uint8_t mmsi_flag = get_bits(s, 42, 4);
+    uint8_t mmsi_flag = trame406_champ(s, 42, 4);
     
     if (mmsi_flag == 0xF) {  // MMSI encoding
         // Bits 47-66: Last 6 digits of MMSI
-        uint32_t mmsi_last6 = get_bits(s, 46, 20);
+        uint32_t mmsi_last6 = trame406_champ(s, 46, 20);
         snprintf(info->vessel_id, sizeof(info->vessel_id), 
                  "RLS MMSI: %06u", mmsi_last6);
     } else {
         // Bits 43-52: TAC or National RLS Number
-        uint16_t tac = get_bits(s, 42, 10);
+        uint16_t tac = trame406_champ(s, 42, 10);
         // Bits 53-66: Serial number
-        uint16_t serial = get_bits(s, 52, 14);
+        uint16_t serial = trame406_champ(s, 52, 14);
         
         const char *type_str[] = {"ELT", "EPIRB", "PLB", "TEST"};
         snprintf(info->vessel_id, sizeof(info->vessel_id),
@@ -705,14 +646,14 @@ static void decode_rls_location(const char *s, BeaconInfo1G *info, int frame_len
     
     // Position data (30 minute resolution)
     // Bits 67-75: Latitude (9 bits)
-    uint8_t ns_flag = (s[66] == '1');  // Bit 67: N/S flag
-    uint8_t lat_half_deg = get_bits(s, 67, 8);  // 0.5 degree increments
+    uint8_t ns_flag = trame406_bit(s, 66);  // Bit 67: N/S flag
+    uint8_t lat_half_deg = trame406_champ(s, 67, 8);  // 0.5 degree increments
     info->base_lat = lat_half_deg * 0.5;
     if (ns_flag) info->base_lat = -info->base_lat;
     
     // Bits 76-85: Longitude (10 bits)
-    uint8_t ew_flag = (s[75] == '1');  // Bit 76: E/W flag
-    uint16_t lon_half_deg = get_bits(s, 76, 9);  // 0.5 degree increments
+    uint8_t ew_flag = trame406_bit(s, 75);  // Bit 76: E/W flag
+    uint16_t lon_half_deg = trame406_champ(s, 76, 9);  // 0.5 degree increments
     info->base_lon = lon_half_deg * 0.5;
     if (ew_flag) info->base_lon = -info->base_lon;
     
@@ -731,14 +672,14 @@ static void decode_rls_location(const char *s, BeaconInfo1G *info, int frame_len
 // ===================================================
 // Identification decoding functions
 // ===================================================
-static void decode_aircraft_address(const char *s, BeaconInfo1G *info) {
+static void decode_aircraft_address(const Trame406 *s, BeaconInfo1G *info) {
     // T.001: bits 43-66 for aircraft 24-bit address (positions 42-65 in 0-indexed)
-    uint32_t addr = get_bits(s, 42, 24);
+    uint32_t addr = trame406_champ(s, 42, 24);
     info->aircraft_address = addr;
     snprintf(info->vessel_id, sizeof(info->vessel_id), "Aircraft %06X", addr);
 }
 
-static void decode_supplementary_data(const char *s, BeaconInfo1G *info) {
+static void decode_supplementary_data(const Trame406 *s, BeaconInfo1G *info) {
     (void)s;
     if (info->frame_type == LONG_FRAME_BITS && info->protocol == PROTOCOL_EMERGENCY_ELT) {
         // Buffer temporaire pour éviter les débordements
@@ -794,57 +735,39 @@ static void decode_supplementary_data(const char *s, BeaconInfo1G *info) {
     }
 }
 
-static int validate_frame_sync(const char *frame, int frame_length) {
+static int validate_frame_sync(const Trame406 *frame, int frame_length) {
     (void)frame_length;
     
     // Check bit sync pattern (15 ones)
-    for (int i = 0; i < 15; i++) {
-        if (frame[i] != '1') {
-            printf("Warning: Bit sync pattern error at position %d\n", i);
-            return 0;
-        }
+    if (trame406_champ(frame, 0, 15) != 0x7FFF) {
+        int i = 0;
+        while (trame406_bit(frame, i)) i++;
+        printf("Warning: Bit sync pattern error at position %d\n", i);
+        return 0;
     }
     
     // Check frame sync pattern
-    uint32_t frame_sync = get_bits(frame, 15, 9);
+    uint32_t frame_sync = trame406_champ(frame, 15, 9);
     
     switch (frame_sync) {
+        case 0b000101111:  // Normal message (T.001)
         case 0b000101101:  // Normal message
         case 0b001010010:  // Self-test message
         case 0b110101000:  // National use
         case 0b011010000:  // Test protocol (0x0D0)
             return 1;
         default:
+            // Most likely a frame slipped by a bit or more
             printf("Warning: Unknown frame sync pattern: %03X\n", frame_sync);
-            return 1;
-    }
-}
-
-// ===================================================
-// Binary to hexadecimal conversion
-// ===================================================
-static void binary_to_hex(const char *binary, int length, char *hex_output, size_t hex_size) {
-    // Clear output buffer
-    memset(hex_output, 0, hex_size);
-    
-    // Process bits 25 to end (skip sync and frame sync patterns)
-    int start_bit = 24;  // Start from bit 25 (index 24)
-    int hex_index = 0;
-    
-    // Process 4 bits at a time to create hex digits
-    for (int i = start_bit; i < length && hex_index < (int)(hex_size - 1); i += 4) {
-        int nibble = 0;
-        for (int j = 0; j < 4 && (i + j) < length; j++) {
-            nibble = (nibble << 1) | (binary[i + j] == '1' ? 1 : 0);
-        }
-        hex_output[hex_index++] = (nibble < 10) ? ('0' + nibble) : ('a' + nibble - 10);
+            return 0;
     }
 }
 
 // ===================================================
 // Main decoding function
 // ===================================================
-static void decode_1g_frame(const char *frame, int frame_length, BeaconInfo1G *info) {
+static void decode_1g_frame(Trame406 *frame, int frame_length, BeaconInfo1G *info,
+                            const uint8_t *fiabilite) {
     memset(info, 0, sizeof(BeaconInfo1G));
     info->frame_type = frame_length;
     info->crc_error = 0;
@@ -857,6 +780,35 @@ static void decode_1g_frame(const char *frame, int frame_length, BeaconInfo1G *i
         crc2_failed = test_crc2(frame);
     }
 
+    // BCH correction of the failing fields, before any field is decoded;
+    // past hard correction, Chase decoding when soft decisions are given
+    int corrected1 = 0, corrected2 = 0;
+    if (crc1_failed) {
+        corrected1 = bch1_corrige(frame);
+        if (corrected1 < 0 && fiabilite && (corrected1 = bch1_chase(frame, fiabilite)) > 0) {
+            info->chase = 1;
+        }
+        if (corrected1 > 0) crc1_failed = 0;
+    }
+    if (crc2_failed) {
+        corrected2 = bch2_corrige(frame);
+        if (corrected2 < 0 && fiabilite && (corrected2 = bch2_chase(frame, fiabilite)) > 0) {
+            info->chase = 1;
+        }
+        if (corrected2 > 0) crc2_failed = 0;
+    }
+    if (corrected1 > 0 || corrected2 > 0) {
+        char hex_str[64];
+        info->bits_corrected = (corrected1 > 0 ? corrected1 : 0) +
+                               (corrected2 > 0 ? corrected2 : 0);
+        trame406_hex(frame, 24, frame_length - 24, 0, hex_str);
+        printf("BCH correction: %d bit(s) corrected (PDF-1: %d, PDF-2: %d)%s\n",
+               info->bits_corrected, corrected1 > 0 ? corrected1 : 0,
+               corrected2 > 0 ? corrected2 : 0,
+               info->chase ? ", Chase decoding on soft decisions" : "");
+        printf("Corrected content: %s\n", hex_str);
+    }
+
     if (crc1_failed || crc2_failed) {
         info->crc_error = 1;
         printf("CRC ERROR: CRC1=%s CRC2=%s\n", 
@@ -865,16 +817,16 @@ static void decode_1g_frame(const char *frame, int frame_length, BeaconInfo1G *i
     }
     
     // Decode country code (bits 27-36, positions 26-35 in 0-indexed)
-    info->country_code = get_bits(frame, 26, 10);
+    info->country_code = trame406_champ(frame, 26, 10);
     
     // Decode protocol code (bits 37-40, positions 36-39 in 0-indexed)
-    int protocol_bits = get_bits(frame, 36, 4);
+    int protocol_bits = trame406_champ(frame, 36, 4);
     info->protocol_bits = protocol_bits;
     
     // Protocol mapping based on T.001
         if (info->frame_type == SHORT_FRAME_BITS) {
         // Short Messages  : User Protocols only (P=1)
-        uint8_t protocol_flag = (frame[25] == '1') ? 1 : 0;  // Bit 26
+        uint8_t protocol_flag = trame406_bit(frame, 25);  // Bit 26
         
         if (protocol_flag != 1) {
             // Short messages should have P=1
@@ -895,7 +847,7 @@ static void decode_1g_frame(const char *frame, int frame_length, BeaconInfo1G *i
         }
     } else {
         // Long Messages : Location or User-Location Protocols
-        uint8_t protocol_flag = (frame[25] == '1') ? 1 : 0;  // Bit 26
+        uint8_t protocol_flag = trame406_bit(frame, 25);  // Bit 26
         
         if (protocol_flag == 0) {
             // Location Protocols (P=0, codes 4 bits)
@@ -932,7 +884,7 @@ static void decode_1g_frame(const char *frame, int frame_length, BeaconInfo1G *i
     
     // For ELT-DT, decode ID type first (bits 41-42)
     if (info->protocol == PROTOCOL_EMERGENCY_ELT) {
-        info->id_type = get_bits(frame, 40, 2);
+        info->id_type = trame406_champ(frame, 40, 2);
         
         // Decode aircraft address if ID type is 0
         if (info->id_type == 0) {
@@ -1036,7 +988,7 @@ switch (info->protocol) {
         // No need to extract again, just use what was set
     } else {
         // For other protocols, standard position
-        info->serial = get_bits(frame, 50, 14);  // Standard position for serial protocols
+        info->serial = trame406_champ(frame, 50, 14);  // Standard position for serial protocols
     }
     
     // Generate hex ID
@@ -1047,35 +999,37 @@ switch (info->protocol) {
 // ===================================================
 // Interface function
 // ===================================================
-void decode_1g(const uint8_t *bits, int length) {
-    if (length != SHORT_FRAME_BITS && length != LONG_FRAME_BITS) {
-        fprintf(stderr, "ERROR: Invalid frame length: %d bits (expected %d or %d)\n", 
-                length, SHORT_FRAME_BITS, LONG_FRAME_BITS);
+void decode_1g(const Trame406 *trame) {
+    decode_1g_soft(trame, NULL);
+}
+
+void decode_1g_soft(const Trame406 *trame, const uint8_t *fiabilite) {
+    if (!trame) {
+        fprintf(stderr, "ERROR: NULL frame\n");
         return;
     }
 
-    if (!bits) {
-        fprintf(stderr, "ERROR: NULL bits array\n");
+    const int length = trame->longueur;
+    if (length != SHORT_FRAME_BITS && length != LONG_FRAME_BITS) {
+        fprintf(stderr, "ERROR: Invalid frame length: %d bits (expected %d or %d)\n", 
+                length, SHORT_FRAME_BITS, LONG_FRAME_BITS);
         return;
     }
 
-    char frame_str[LONG_FRAME_BITS + 1];
-    for (int i = 0; i < length; i++) {
-        frame_str[i] = (bits[i] & 1) ? '1' : '0';
-    }
-    frame_str[length] = '\0';
-    
-    // Generate and display hexadecimal representation
+    // Display bits 25 to end (skip sync and frame sync patterns) in hex
     char hex_str[64];
-    binary_to_hex(frame_str, length, hex_str, sizeof(hex_str));
+    trame406_hex(trame, 24, length - 24, 0, hex_str);
     printf("Hexadecimal content: %s\n", hex_str);
 
-    if (!validate_frame_sync(frame_str, length)) {
+    // Without a clean sync the frame may be slipped: no Chase decoding
+    if (!validate_frame_sync(trame, length)) {
         printf("Warning: Frame synchronization issues detected\n");
+        fiabilite = NULL;
     }
 
     BeaconInfo1G info;
-    decode_1g_frame(frame_str, length, &info);
+    Trame406 frame = *trame;
+    decode_1g_frame(&frame, length, &info, fiabilite);
     
     char coord_buf[100] = "Position not available";
     if (info.has_position && (info.lat != 0.0 || info.lon != 0.0)) {
@@ -1089,6 +1043,9 @@ void decode_1g(const uint8_t *bits, int length) {
     
     if (info.crc_error) {
         printf("\nCRC ERROR - Data may be corrupted\n");
+    } else if (info.bits_corrected > 0) {
+        printf("\nBCH: %d bit error(s) corrected%s\n", info.bits_corrected,
+               info.chase ? " (Chase decoding)" : "");
     }
     
     printf("\n=== 406 MHz BEACON DECODE (1G %s) ===", 
@@ -1216,16 +1173,6 @@ void decode_1g(const uint8_t *bits, int length) {
 // Additional decoder functions from dec406_V7 
 // ===================================================
 
-// Helper function to calculate value from bit range (adapted from dec406_V7)
-static int calculate_bit_value(const char *bits, int start, int end) {
-    int i, y = 0, x = 1;
-    for (i = end; i >= start; i--) {
-        if (bits[i] == '1') y = y + x;
-        x = 2 * x;
-    }
-    return y;
-}
-
 // Helper function to print hex byte (adapted from dec406_V7)
 static void print_hex_byte(int x) {
     int a, b;
@@ -1236,7 +1183,7 @@ static void print_hex_byte(int x) {
 }
 
 // Orbitography/calibration beacon decoder (adapted from dec406_V7)
-static void decode_orbitography_data(const char *bits, BeaconInfo1G *info) {
+static void decode_orbitography_data(const Trame406 *bits, BeaconInfo1G *info) {
     int i, j, a;
     
     printf("Orbitography data: ");
@@ -1244,13 +1191,13 @@ static void decode_orbitography_data(const char *bits, BeaconInfo1G *info) {
     // Extract 5 bytes of orbitography data (bits 39-78)
     for (j = 0; j < 5; j++) {
         i = 39 + j * 8;
-        a = calculate_bit_value(bits, i, i + 7);
+        a = trame406_champ(bits, i, 8);
         print_hex_byte(a);
     }
     
     // Extract final 6-bit value (bits 79-84) 
     i = 79;
-    a = calculate_bit_value(bits, i, i + 5);
+    a = trame406_champ(bits, i, 6);
     printf("%02d", a);
     
     // Mark as system beacon with no position data
@@ -1276,47 +1223,47 @@ static char decode_baudot_char(int x) {
 }
 
 // Display 6-character Baudot string (Aviation User Protocol)
-static void display_baudot_42(const char *bits) {
+static void display_baudot_42(const Trame406 *bits) {
     printf(" Call sign: ");
     for (int j = 0; j < 6; j++) {
         int i = 39 + j * 6;
-        int a = calculate_bit_value(bits, i, i + 5);
+        int a = trame406_champ(bits, i, 6);
         printf("%c", decode_baudot_char(a));
     }
 }
 
 // Display 7-character Baudot string (Aviation Extended)
-static void display_baudot_2(const char *bits) {
+static void display_baudot_2(const Trame406 *bits) {
     printf(" Call sign: ");
     for (int j = 0; j < 7; j++) {
         int i = 39 + j * 6;
-        int a = calculate_bit_value(bits, i, i + 5);
+        int a = trame406_champ(bits, i, 6);
         printf("%c", decode_baudot_char(a));
     }
 }
 
 // Specific beacon identification (from dec406_V7)
-static void display_specific_beacon(const char *bits) {
+static void display_specific_beacon(const Trame406 *bits) {
     printf(" Specific beacon: ");
     int i = 75;
-    int a = calculate_bit_value(bits, i, i + 5);
+    int a = trame406_champ(bits, i, 6);
     printf("%c", decode_baudot_char(a));
 }
 
 // Standard test protocol decoder (from dec406_V7)
-static void decode_standard_test_data(const char *bits, BeaconInfo1G *info) {
+static void decode_standard_test_data(const Trame406 *bits, BeaconInfo1G *info) {
     printf("Test data: ");
     
     // Display raw test data (bits 40-63)
     for (int i = 40; i < 64; i++) {
-        printf("%c", bits[i]);
+        printf("%c", '0' + trame406_bit(bits, i));
     }
     printf(" (hex: ");
     
     // Display as 3 hex bytes
     for (int j = 0; j < 3; j++) {
         int i = 40 + j * 8;
-        int a = calculate_bit_value(bits, i, i + 7);
+        int a = trame406_champ(bits, i, 8);
         print_hex_byte(a);
     }
     printf(")");
@@ -1326,13 +1273,13 @@ static void decode_standard_test_data(const char *bits, BeaconInfo1G *info) {
 }
 
 // Test beacon data decoder (from dec406_V7)
-static void decode_test_beacon_data(const char *bits, BeaconInfo1G *info) {
+static void decode_test_beacon_data(const Trame406 *bits, BeaconInfo1G *info) {
     printf("Test beacon data: ");
     
     // Extract test data (adapted from dec406_V7)
     for (int j = 0; j < 5; j++) {
         int i = 39 + j * 8;
-        int a = calculate_bit_value(bits, i, i + 7);
+        int a = trame406_champ(bits, i, 8);
         print_hex_byte(a);
     }
     
@@ -1341,32 +1288,32 @@ static void decode_test_beacon_data(const char *bits, BeaconInfo1G *info) {
 }
 
 // National use decoder (from dec406_V7)
-static void decode_national_use_data(const char *bits, BeaconInfo1G *info) {
+static void decode_national_use_data(const Trame406 *bits, BeaconInfo1G *info) {
     printf("National use data: ");
     
     // Extract 5 bytes + 2 additional 6-bit values (from dec406_V7)
     for (int j = 0; j < 5; j++) {
         int i = 39 + j * 8;
-        int a = calculate_bit_value(bits, i, i + 7);
+        int a = trame406_champ(bits, i, 8);
         print_hex_byte(a);
     }
     
     // Additional values at bits 79-84 and 106-111
-    int a1 = calculate_bit_value(bits, 79, 84);
-    int a2 = calculate_bit_value(bits, 106, 111);
+    int a1 = trame406_champ(bits, 79, 6);
+    int a2 = trame406_champ(bits, 106, 6);
     printf("%02d%02d", a1, a2);
     
     strcpy(info->hex_id, "NAT-USE");
 }
 
 // Radio Call Sign User Protocol decoder (from dec406_V7)
-static void decode_radio_callsign_data(const char *bits, BeaconInfo1G *info) {
+static void decode_radio_callsign_data(const Trame406 *bits, BeaconInfo1G *info) {
     printf("Radio call sign: ");
     
     // Extract radio call sign data using Baudot encoding
     for (int j = 0; j < 7; j++) {
         int i = 39 + j * 6;
-        int a = calculate_bit_value(bits, i, i + 5);
+        int a = trame406_champ(bits, i, 6);
         printf("%c", decode_baudot_char(a));
     }
     
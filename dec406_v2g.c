@@ -22,43 +22,7 @@
 #include "dec406.h"
 #include "display_utils.h"
 #include "country_codes.h"
-
-// ===================================================
-// BCH Error Correction Implementation (T.018 Appendix B)
-// ===================================================
-#define BCH_POLY 0x1C7D72F93C97  // Polynomial: 1110001111110101110000101110111110011110010010111
-
-/**
- * @brief Decodes BCH(250,202) encoded message
- * @param msg Input: 250-bit raw message
- * @param out Output: 202-bit corrected data
- * 
- * Implements BCH error detection/correction as specified in
- * C/S T.018 Appendix B using the defined generator polynomial.
- */
-static void bch_decode_250_202(const uint8_t *msg, uint8_t *out) {
-    const int poly_degree = 48;
-    uint64_t shift_reg = 0;
-    
-    // Syndrome calculation
-    for (int i = 0; i < 250; i++) {
-        uint8_t bit = (msg[i] ^ (shift_reg >> (poly_degree - 1))) & 1;
-        shift_reg = (shift_reg << 1) | bit;
-        
-        if (shift_reg & (1ULL << poly_degree)) {
-            shift_reg ^= BCH_POLY;
-        }
-    }
-    
-    // Error detection
-    if (shift_reg != 0) {
-        fprintf(stderr, "BCH: Errors detected (syndrome: 0x%012lX)\n", shift_reg);
-        // Advanced correction logic would go here
-    }
-    
-    // Extract information bits (first 202 bits)
-    memcpy(out, msg, 202);
-}
+#include "bch406.h"
 
 // ===================================================
 // Modified Baudot Decoding Table (Table 3.2 - T.018 Specification)
@@ -79,8 +43,6 @@ static const char *baudot_table[64] = {
 // ===================================================
 // Beacon Information Structure
 // ===================================================
-#define BCH_N 250
-#define BCH_K 202
 #define MAIN_BITS 154
 #define ROT_BITS 48
 
@@ -150,25 +112,23 @@ typedef struct {
         };
     } rot;
     
-    uint8_t raw_data[202];  // Store raw data for validation
+    Trame406 raw_data;  // Store raw data for validation
+    int bch_corrected;  // Bits corrected by BCH (250,202), -1 if uncorrectable
+    int bch_chase;      // Corrected by Chase decoding on soft decisions
 } BeaconInfo;
 
 // ===================================================
 // Utility Functions
 // ===================================================
 /**
- * @brief Extracts bits from a bit array
- * @param bits Source bit array
- * @param start Starting bit index
+ * @brief Extracts a rotating field value
+ * @param bits Source frame
+ * @param start Starting bit index within the rotating field
  * @param len Number of bits to extract
  * @return Extracted value
  */
-static uint32_t get_bits(const uint8_t *bits, int start, int len) {
-    uint32_t val = 0;
-    for (int i = 0; i < len; i++) {
-        val = (val << 1) | bits[start + i];
-    }
-    return val;
+static uint32_t get_rot_bits(const Trame406 *bits, int start, int len) {
+    return trame406_champ(bits, MAIN_BITS + start, len);
 }
 
 /**
@@ -180,18 +140,18 @@ static uint32_t get_bits(const uint8_t *bits, int start, int len) {
  * Implements position decoding as specified in Section 3.2
  * with 3.4 meter resolution and default value handling.
  */
-static void decode_position(const uint8_t *bits, double *lat, double *lon) {
+static void decode_position(const Trame406 *bits, double *lat, double *lon) {
     // Position decoding according to T.018 Section 3.2 (bits are 0-indexed)
     // Latitude: bit 44 (N/S), bits 45-51 (degrees), bits 52-66 (decimal fraction)
     // Longitude: bit 67 (E/W), bits 68-75 (degrees), bits 76-90 (decimal fraction)
     
-    int ns_flag = bits[43];  // bit 44 in T.018 = index 43 in 0-based array
-    int lat_deg = get_bits(bits, 44, 7);   // bits 45-51 in T.018
-    int lat_frac = get_bits(bits, 51, 15); // bits 52-66 in T.018
+    int ns_flag = trame406_bit(bits, 43);  // bit 44 in T.018 = index 43 in 0-based array
+    int lat_deg = trame406_champ(bits, 44, 7);   // bits 45-51 in T.018
+    int lat_frac = trame406_champ(bits, 51, 15); // bits 52-66 in T.018
     
-    int ew_flag = bits[66];  // bit 67 in T.018 = index 66 in 0-based array
-    int lon_deg = get_bits(bits, 67, 8);   // bits 68-75 in T.018  
-    int lon_frac = get_bits(bits, 75, 15); // bits 76-90 in T.018
+    int ew_flag = trame406_bit(bits, 66);  // bit 67 in T.018 = index 66 in 0-based array
+    int lon_deg = trame406_champ(bits, 67, 8);   // bits 68-75 in T.018  
+    int lon_frac = trame406_champ(bits, 75, 15); // bits 76-90 in T.018
     
     // Check for default values (T.018 Section 3.2) indicating no position capability
     // Latitude default: 0 1111111 000001111100000
@@ -226,17 +186,17 @@ static void decode_position(const uint8_t *bits, double *lat, double *lon) {
  * @param bits Source bit array (202 information bits)
  * @param info Output: Decoded beacon information
  */
-static void decode_main(const uint8_t *bits, BeaconInfo *info) {
+static void decode_main(const Trame406 *bits, BeaconInfo *info) {
     // Store raw data for validation
-    memcpy(info->raw_data, bits, 202);
+    info->raw_data = *bits;
     
     // Decode fixed fields (T.018 Section 3.2 - convert 1-based to 0-based indices)
-    info->tac = get_bits(bits, 0, 16);      // bits 1-16 in T.018
-    info->serial = get_bits(bits, 16, 14);  // bits 17-30 in T.018
-    info->country = get_bits(bits, 30, 10); // bits 31-40 in T.018
-    info->homing = bits[40];                // bit 41 in T.018
-    info->rls = bits[41];                   // bit 42 in T.018
-    info->test = bits[42];                  // bit 43 in T.018
+    info->tac = trame406_champ(bits, 0, 16);      // bits 1-16 in T.018
+    info->serial = trame406_champ(bits, 16, 14);  // bits 17-30 in T.018
+    info->country = trame406_champ(bits, 30, 10); // bits 31-40 in T.018
+    info->homing = trame406_bit(bits, 40);                // bit 41 in T.018
+    info->rls = trame406_bit(bits, 41);                   // bit 42 in T.018
+    info->test = trame406_bit(bits, 42);                  // bit 43 in T.018
     
     // Decode position
     decode_position(bits, &info->lat, &info->lon);
@@ -244,10 +204,10 @@ static void decode_main(const uint8_t *bits, BeaconInfo *info) {
     info->has_position = (info->lat != 0.0 || info->lon != 0.0) ? 1 : 0;
     
     // Vessel ID type (bits 91-93 in T.018)
-    info->vessel_id_type = get_bits(bits, 90, 3);
+    info->vessel_id_type = trame406_champ(bits, 90, 3);
     
     // Beacon type (bits 138-140 in T.018)
-    info->beacon_type = get_bits(bits, 137, 3);
+    info->beacon_type = trame406_champ(bits, 137, 3);
 }
 
 // ===================================================
@@ -255,19 +215,19 @@ static void decode_main(const uint8_t *bits, BeaconInfo *info) {
 // ===================================================
 /**
  * @brief Decodes rotating field (48 bits)
- * @param rot_bits Source bit array (rotating field)
+ * @param bits Source frame, rotating field after the main field
  * @param info Output: Decoded rotating field information
  */
-static void decode_rot_field(const uint8_t *rot_bits, BeaconInfo *info) {
-    info->rot.id = get_bits(rot_bits, 0, 4);
+static void decode_rot_field(const Trame406 *bits, BeaconInfo *info) {
+    info->rot.id = get_rot_bits(bits, 0, 4);
     
     switch(info->rot.id) {
         case 0:  // G.008 Objective Requirements
-            info->rot.g008_obj.elapsed_time = get_bits(rot_bits, 4, 6);
-            info->rot.g008_obj.time_last_loc = get_bits(rot_bits, 10, 11);
+            info->rot.g008_obj.elapsed_time = get_rot_bits(bits, 4, 6);
+            info->rot.g008_obj.time_last_loc = get_rot_bits(bits, 10, 11);
             
             // Altitude decoding with special cases
-            uint16_t alt_code = get_bits(rot_bits, 21, 10);
+            uint16_t alt_code = get_rot_bits(bits, 21, 10);
             if (alt_code == 0x3FF) {  // Not available
                 info->rot.g008_obj.altitude = -32768;
             } else {
@@ -275,55 +235,55 @@ static void decode_rot_field(const uint8_t *rot_bits, BeaconInfo *info) {
             }
             
             // DOP values
-            uint8_t dop = get_bits(rot_bits, 31, 8);
+            uint8_t dop = get_rot_bits(bits, 31, 8);
             info->rot.g008_obj.hdop = dop >> 4;
             info->rot.g008_obj.vdop = dop & 0x0F;
             
             // Activation and battery
-            info->rot.g008_obj.activation_method = get_bits(rot_bits, 39, 2);
-            info->rot.g008_obj.battery_capacity = get_bits(rot_bits, 41, 3);
-            info->rot.g008_obj.gnss_status = get_bits(rot_bits, 44, 2);
+            info->rot.g008_obj.activation_method = get_rot_bits(bits, 39, 2);
+            info->rot.g008_obj.battery_capacity = get_rot_bits(bits, 41, 3);
+            info->rot.g008_obj.gnss_status = get_rot_bits(bits, 44, 2);
             break;
         
         case 1:  // In-Flight Emergency
-            info->rot.in_flight.time_last_loc = get_bits(rot_bits, 4, 17);
+            info->rot.in_flight.time_last_loc = get_rot_bits(bits, 4, 17);
             
-            alt_code = get_bits(rot_bits, 21, 10);
+            alt_code = get_rot_bits(bits, 21, 10);
             if (alt_code == 0x3FF) {  // Not available
                 info->rot.in_flight.altitude = -32768;
             } else {
                 info->rot.in_flight.altitude = (alt_code * 16) - 400;
             }
             
-            info->rot.in_flight.triggering_event = get_bits(rot_bits, 31, 4);
-            info->rot.in_flight.gnss_status = get_bits(rot_bits, 35, 2);
-            info->rot.in_flight.battery_capacity = get_bits(rot_bits, 37, 2);
+            info->rot.in_flight.triggering_event = get_rot_bits(bits, 31, 4);
+            info->rot.in_flight.gnss_status = get_rot_bits(bits, 35, 2);
+            info->rot.in_flight.battery_capacity = get_rot_bits(bits, 37, 2);
             break;
         
         case 2:  // RLS Acknowledgement
-            info->rot.rls_ack.capability_auto_ack = rot_bits[6];
-            info->rot.rls_ack.capability_manual_ack = rot_bits[7];
-            info->rot.rls_ack.rls_provider = get_bits(rot_bits, 12, 3);
-            info->rot.rls_ack.feedback_type1 = rot_bits[15];
-            info->rot.rls_ack.feedback_type2 = rot_bits[16];
-            info->rot.rls_ack.rlm_data = get_bits(rot_bits, 17, 20);
+            info->rot.rls_ack.capability_auto_ack = get_rot_bits(bits, 6, 1);
+            info->rot.rls_ack.capability_manual_ack = get_rot_bits(bits, 7, 1);
+            info->rot.rls_ack.rls_provider = get_rot_bits(bits, 12, 3);
+            info->rot.rls_ack.feedback_type1 = get_rot_bits(bits, 15, 1);
+            info->rot.rls_ack.feedback_type2 = get_rot_bits(bits, 16, 1);
+            info->rot.rls_ack.rlm_data = get_rot_bits(bits, 17, 20);
             break;
         
         case 4:  // Two-Way Communication (T.018 Table 3.7)
-            info->rot.twc.twc_provider = get_bits(rot_bits, 4, 3);
-            info->rot.twc.version_id = get_bits(rot_bits, 7, 5);
-            info->rot.twc.twc_ack_received = rot_bits[12];
+            info->rot.twc.twc_provider = get_rot_bits(bits, 4, 3);
+            info->rot.twc.version_id = get_rot_bits(bits, 7, 5);
+            info->rot.twc.twc_ack_received = get_rot_bits(bits, 12, 1);
             // Spare bits 13-14 (2 bits)
-            info->rot.twc.questionA = get_bits(rot_bits, 15, 7);  // bits 16-22 in message
-            info->rot.twc.answerA = get_bits(rot_bits, 22, 4);    // bits 23-26 in message
-            info->rot.twc.questionB = get_bits(rot_bits, 26, 7);  // bits 27-33 in message
-            info->rot.twc.answerB = get_bits(rot_bits, 33, 4);    // bits 34-37 in message
-            info->rot.twc.questionC = get_bits(rot_bits, 37, 7);  // bits 38-44 in message
-            info->rot.twc.answerC = get_bits(rot_bits, 44, 4);    // bits 45-48 in message
+            info->rot.twc.questionA = get_rot_bits(bits, 15, 7);  // bits 16-22 in message
+            info->rot.twc.answerA = get_rot_bits(bits, 22, 4);    // bits 23-26 in message
+            info->rot.twc.questionB = get_rot_bits(bits, 26, 7);  // bits 27-33 in message
+            info->rot.twc.answerB = get_rot_bits(bits, 33, 4);    // bits 34-37 in message
+            info->rot.twc.questionC = get_rot_bits(bits, 37, 7);  // bits 38-44 in message
+            info->rot.twc.answerC = get_rot_bits(bits, 44, 4);    // bits 45-48 in message
             break;
         
         case 15:  // Cancellation Message
-            info->rot.cancellation.deactivation_method = get_bits(rot_bits, 46, 2);
+            info->rot.cancellation.deactivation_method = get_rot_bits(bits, 46, 2);
             break;
     }
 }
@@ -337,7 +297,7 @@ static void decode_rot_field(const uint8_t *rot_bits, BeaconInfo *info) {
  * @param type Identification type (0-5)
  * @param output Output: Formatted identification string
  */
-static void decode_vessel_id(const uint8_t *bits, int type, char *output) {
+static void decode_vessel_id(const Trame406 *bits, int type, char *output) {
     output[0] = '\0';  // Initialize output
     
     switch(type) {
@@ -347,8 +307,8 @@ static void decode_vessel_id(const uint8_t *bits, int type, char *output) {
             
         case 1:  // Maritime MMSI (T.018 Section 3.2)
             {
-                uint32_t mmsi = get_bits(bits, 93, 30);  // 30-bit MMSI from bits 94-123
-                uint16_t ais_suffix = get_bits(bits, 123, 14);  // AIS suffix from bits 124-137
+                uint32_t mmsi = trame406_champ(bits, 93, 30);  // 30-bit MMSI from bits 94-123
+                uint16_t ais_suffix = trame406_champ(bits, 123, 14);  // AIS suffix from bits 124-137
                 
                 if (mmsi == 0x1FFFF) {  // Default decimal 000111111 for no MMSI
                     strcpy(output, "No MMSI Available");
@@ -373,7 +333,7 @@ static void decode_vessel_id(const uint8_t *bits, int type, char *output) {
                 
                 for (int i = 0; i < 7; i++) {
                     int start_bit = 93 + i * 6;
-                    int code = get_bits(bits, start_bit, 6);
+                    int code = trame406_champ(bits, start_bit, 6);
                     
                     // Look up in Modified Baudot table
                     const char *ch = baudot_table[code];
@@ -406,9 +366,9 @@ static void decode_vessel_id(const uint8_t *bits, int type, char *output) {
             
         case 4:  // Aircraft 24-bit Address (T.018 Section 3.2)
             {
-                uint32_t addr = get_bits(bits, 93, 24);  // bits 94-117
-                uint32_t operator_3ld = get_bits(bits, 117, 15);  // bits 118-132 (3x5 bits)
-                uint8_t spare = get_bits(bits, 132, 5);  // bits 133-137 spare
+                uint32_t addr = trame406_champ(bits, 93, 24);  // bits 94-117
+                uint32_t operator_3ld = trame406_champ(bits, 117, 15);  // bits 118-132 (3x5 bits)
+                uint8_t spare = trame406_champ(bits, 132, 5);  // bits 133-137 spare
                 
                 sprintf(output, "ICAO24:%06X", addr);
                 
@@ -429,11 +389,11 @@ static void decode_vessel_id(const uint8_t *bits, int type, char *output) {
         case 5:  // Aircraft Operator + Serial (T.018 Section 3.2)
             {
                 // 3-letter operator designator (bits 94-108, 3x5 bits)
-                uint32_t operator_3ld = get_bits(bits, 93, 15);
+                uint32_t operator_3ld = trame406_champ(bits, 93, 15);
                 // Serial number (bits 109-120, 12 bits)
-                uint16_t serial = get_bits(bits, 108, 12);
+                uint16_t serial = trame406_champ(bits, 108, 12);
                 // Spare bits (bits 121-137, 17 bits) should be all 1's
-                uint32_t spare = get_bits(bits, 120, 17);
+                uint32_t spare = trame406_champ(bits, 120, 17);
                 
                 if (operator_3ld != 0) {
                     char op_code[4] = {0};
@@ -468,27 +428,23 @@ static void decode_vessel_id(const uint8_t *bits, int type, char *output) {
  * Constructs the unique 23-character hexadecimal identifier
  * according to the specification in Table 3.11.
  */
-static void compute_hex_id(const uint8_t *bits, BeaconInfo *info) {
-    uint8_t id_bits[92] = {0};  // 92 bits for 23 hex characters
+static void compute_hex_id(const Trame406 *bits, BeaconInfo *info) {
+    Trame406 id;  // 92 bits for 23 hex characters
     
     // Construct bit sequence (Table 3.11)
-    id_bits[0] = 1;  // Fixed '1'
-    for (int i = 0; i < 10; i++) id_bits[1 + i] = bits[30 + i];  // Country code
-    id_bits[11] = 1; id_bits[12] = 0; id_bits[13] = 1;  // Fixed '101'
-    for (int i = 0; i < 16; i++) id_bits[14 + i] = bits[i];  // TAC
-    for (int i = 0; i < 14; i++) id_bits[30 + i] = bits[16 + i];  // Serial
-    id_bits[44] = bits[42];  // Test protocol flag
-    for (int i = 0; i < 3; i++) id_bits[45 + i] = bits[90 + i];  // ID type
-    for (int i = 0; i < 44; i++) id_bits[48 + i] = bits[93 + i];  // ID content
+    trame406_efface(&id, 92);
+    trame406_pose(&id, 0, 1, 1);  // Fixed '1'
+    trame406_pose(&id, 1, 10, trame406_champ(bits, 30, 10));  // Country code
+    trame406_pose(&id, 11, 3, 0x5);  // Fixed '101'
+    trame406_pose(&id, 14, 16, trame406_champ(bits, 0, 16));  // TAC
+    trame406_pose(&id, 30, 14, trame406_champ(bits, 16, 14));  // Serial
+    trame406_pose(&id, 44, 1, trame406_bit(bits, 42));  // Test protocol flag
+    trame406_pose(&id, 45, 3, trame406_champ(bits, 90, 3));  // ID type
+    trame406_pose(&id, 48, 22, trame406_champ(bits, 93, 22));  // ID content
+    trame406_pose(&id, 70, 22, trame406_champ(bits, 115, 22));
     
     // Convert to hexadecimal
-    for (int i = 0; i < 23; i++) {
-        uint8_t nibble = 0;
-        for (int j = 0; j < 4; j++) {
-            nibble = (nibble << 1) | id_bits[i * 4 + j];
-        }
-        sprintf(info->hex_id + i, "%1X", nibble);
-    }
+    trame406_hex(&id, 0, 92, 1, info->hex_id);
 }
 
 // ===================================================
@@ -515,8 +471,8 @@ static void validate_gnss(BeaconInfo *info) {
     }
     
     // Check default values (no position available)
-    if (get_bits(info->raw_data, 43, 1) == 1 && 
-        get_bits(info->raw_data, 67, 1) == 1) {
+    if (trame406_bit(&info->raw_data, 43) == 1 && 
+        trame406_bit(&info->raw_data, 67) == 1) {
         info->lat = 0.0;
         info->lon = 0.0;
     }
@@ -566,31 +522,40 @@ static void validate_beacon_type(BeaconInfo *info) {
 
 static void print_beacon_info(const BeaconInfo *info);
 
-void decode_2g(const uint8_t *rx_bits) {
-    uint8_t corrected[BCH_K];  // Corrected information bits
+void decode_2g(const Trame406 *rx_bits) {
+    decode_2g_soft(rx_bits, NULL);
+}
+
+void decode_2g_soft(const Trame406 *rx_bits, const uint8_t *fiabilite) {
+    Trame406 corrected = *rx_bits;  // Corrected information bits
     BeaconInfo info;
     memset(&info, 0, sizeof(info));
     
-    // 1. Apply BCH error correction
-    bch_decode_250_202(rx_bits, corrected);
+    // 1. Apply BCH error correction (up to 6 bits, frame untouched if more),
+    //    then Chase decoding when soft decisions are given
+    info.bch_corrected = bch2g_corrige(&corrected);
+    if (info.bch_corrected < 0 && fiabilite) {
+        info.bch_corrected = bch2g_chase(&corrected, fiabilite);
+        info.bch_chase = (info.bch_corrected > 0);
+    }
     
     // 2. Decode main field (154 bits)
-    decode_main(corrected, &info);
+    decode_main(&corrected, &info);
     
     // 3. Validate position data
     validate_gnss(&info);
     
     // 4. Decode rotating field (48 bits)
-    decode_rot_field(corrected + MAIN_BITS, &info);
+    decode_rot_field(&corrected, &info);
     
     // 5. Validate beacon type consistency
     validate_beacon_type(&info);
     
     // 6. Decode vessel/aircraft ID
-    decode_vessel_id(corrected, info.vessel_id_type, info.vessel_id);
+    decode_vessel_id(&corrected, info.vessel_id_type, info.vessel_id);
     
     // 7. Generate 23 Hex ID
-    compute_hex_id(corrected, &info);
+    compute_hex_id(&corrected, &info);
     
     // 8. Print decoded information
     print_beacon_info(&info);
@@ -630,6 +595,14 @@ void print_beacon_info(const BeaconInfo *info) {
     printf("\n Homing Device: %s", info->homing ? "Available/Active" : "Not Available/Disabled");
     printf("\n RLS Capability: %s", info->rls ? "Enabled" : "Disabled");
     printf("\n Test Protocol: %s", info->test ? "Active (Non-operational)" : "Normal Operation");
+    if (info->bch_corrected < 0) {
+        printf("\n BCH: Uncorrectable (more than %d bit errors)", BCH2G_T);
+    } else if (info->bch_corrected > 0) {
+        printf("\n BCH: %d bit error(s) corrected%s", info->bch_corrected,
+               info->bch_chase ? " (Chase decoding on soft decisions)" : "");
+    } else {
+        printf("\n BCH: Valid");
+    }
     
     
     printf("\n\n[ENCODED GNSS LOCATION]");
@@ -20,14 +20,14 @@ my $j;
 my $frq=0;
 #my $dec = './dec406 --100 --M3 --une_minute';
 #my $dec1 = './dec406 --100 --M3 --une_minute --osm';
-my $dec = './dec406 --100 --M3';
-my $dec1 = './dec406 --100 --M3 --osm';
+my $dec = './dec406 --100 --banc';
+my $dec1 = './dec406 --100 --banc --osm';
 my $timeout_duration = 15; # Timeout optimisé: 15s pour tests (5s), 50s pour balises réelles
 my $timeout_min = 30;      # Timeout minimum (balises test/urgence)
 my $timeout_max = 120;     # Timeout maximum (balises faibles)
 my $scan_count = 0;        # Compteur de scans sans détection 
-#my $filter = "lowpass 3000 highpass 400"; #highpass de 10Hz à 400Hz selon la qualité du signal
-my $filter = "lowpass 3000 highpass 10";
+#my $filter = "--filtre --passe_haut=400 --passe_bas=3000"; #highpass de 10Hz à 400Hz selon la qualité du signal
+my $filter = "--filtre --passe_haut=10 --passe_bas=3000";
 
 #my $largeur = "12k";
 #my $WFM="";
@@ -77,7 +77,7 @@ while (1) {
         print "  [PulseAudio détecté]\n" if ($scan_count == 0);
     }
     
-    system("timeout ${timeout_duration}s  stdbuf -i0 -o0 -e0 $audio_cmd -t wav - $filter 2>/dev/null | stdbuf -i0 -o0 -e0 $dec 1>./trame.asc 2>./code ");  
+    system("timeout ${timeout_duration}s  stdbuf -i0 -o0 -e0 $audio_cmd -t wav - 2>/dev/null | stdbuf -i0 -o0 -e0 $dec $filter 1>./trame.asc 2>./code ");  
       
     $trouve="PAS encore trouve";
     my $ligne;
@@ -0,0 +1,1264 @@
+/**********************************
+
+## Licence
+
+ Licence Creative Commons CC BY-NC-SA 
+
+## Auteurs et contributions
+
+- **Code original dec406_v7** : F4EHY (2020)
+- **Refactoring et support 2G** : Développement collaboratif (2025)
+- **Conformité T.018** : Implémentation complète BCH + MID database
+
+***********************************/
+
+// demod_1g.c - 1G demodulator (correlator, sync search, bit slicer)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "demod_1g.h"
+#include "audio_filter.h"
+#include "demod_kernels.h"
+#include "bch406.h"
+
+// ===================================================
+// Sliding-window correlator
+// ===================================================
+// Y1 = sum over the last 2*Nb samples of (x[a]-moy)*(x[a+Nb]-moy).
+// Expanding the product gives Y1 = P - S*S/(4*Nb), with P the sum of
+// lag-Nb products and S the window sum, both updated in O(1) per sample.
+// Samples are integers, so P and S stay exact in double (< 2^53) and the
+// result does not depend on the order of the sums. Samples are processed
+// in chunks through the vectorized kernels of demod_kernels.c.
+//
+// The integer build keeps P and S in 64 bits and outputs 4*Nb*Y1 shifted
+// right by decalage: 16-bit samples bound it by Nb^2 * 2^33, which the
+// shift brings within 32 bits. Every later stage works on these outputs,
+// with levels converted by demod_unites().
+#define BLOC_CORREL 4096
+
+typedef struct {
+    EchCorrel *h;  // 2*Nb samples of history followed by the current chunk
+    EchCorrel *d;  // Lag-product increments
+    EchCorrel *e;  // Window-sum increments
+    SommeCorrel *p; // Running sums P and S after each sample
+    SommeCorrel *s;
+    int Nb;        // Lag in samples (one bit)
+    int decalage;  // Output shift of the integer build
+    SommeCorrel S; // Sum of the 2*Nb samples in the window
+    SommeCorrel P; // Sum of x[a]*x[a+Nb] over the window
+} Correlateur;
+
+static int correl_init(Correlateur *c, int Nb) {
+    c->d = malloc(BLOC_CORREL * sizeof(EchCorrel));
+    c->e = malloc(BLOC_CORREL * sizeof(EchCorrel));
+    c->p = malloc(BLOC_CORREL * sizeof(SommeCorrel));
+    c->s = malloc(BLOC_CORREL * sizeof(SommeCorrel));
+    c->h = malloc((2 * Nb + BLOC_CORREL) * sizeof(EchCorrel));
+    if (!c->d || !c->e || !c->p || !c->s || !c->h) return 1;
+    c->Nb = Nb;
+    for (c->decalage = 2; (long long)Nb * Nb > 1LL << (c->decalage - 2); c->decalage++) {}
+    return 0;
+}
+
+static void correl_raz(Correlateur *c) {
+    c->S = 0;
+    c->P = 0;
+    memset(c->h, 0, 2 * c->Nb * sizeof(EchCorrel));
+}
+
+// Restart on 2*Nb samples taken as history, without output for them
+static void correl_amorce(Correlateur *c, const short *x) {
+    int a;
+
+    noyaux.convertit(x, 2 * c->Nb, c->h);
+    c->S = 0;
+    c->P = 0;
+    for (a = 0; a < 2 * c->Nb; a++) c->S += c->h[a];
+    for (a = 0; a < c->Nb; a++) c->P += (SommeCorrel)c->h[a] * c->h[a + c->Nb];
+}
+
+static void correl_libere(Correlateur *c) {
+    free(c->h);
+    free(c->d);
+    free(c->e);
+    free(c->p);
+    free(c->s);
+}
+
+// Correlate n <= BLOC_CORREL new samples, one Y1 per sample
+static void correl_bloc(Correlateur *c, const short *x, int n, ValeurCorrel *Y1) {
+    int n2 = 2 * c->Nb;
+    SommeCorrel P = c->P;
+    SommeCorrel S = c->S;
+    int t;
+
+    noyaux.convertit(x, n, c->h + n2);
+    noyaux.increments(c->h, c->Nb, n, c->d, c->e);
+    for (t = 0; t < n; t++) {
+        P += c->d[t];
+        S += c->e[t];
+        c->p[t] = P;
+        c->s[t] = S;
+    }
+#ifdef DEMOD_ENTIER
+    noyaux.correlation(c->p, c->s, n, 2 * n2, c->decalage, Y1);
+#else
+    noyaux.correlation(c->p, c->s, n, 2.0 * n2, Y1);
+#endif
+
+    c->P = P;
+    c->S = S;
+    memmove(c->h, c->h + n, n2 * sizeof(EchCorrel));
+}
+
+// ===================================================
+// Sync matched filter
+// ===================================================
+// A burst opens with 15 ones and the 9-bit frame sync. Y1 is high over a
+// bit equal to the previous one and low over a change, so bits 2-24 give a
+// fixed two-level pattern of 23 slots of Nb outputs, one per frame sync
+// (T.001: 000101111 normal, 011010000 self-test). The levels are not
+// symmetric (a discriminator gives about +2 and -1), so Y1 is compared with
+// both patterns by their correlation coefficient over the span, from prefix
+// sums of Y1 and Y1^2; the product with the pattern reduces to the few run
+// boundaries of its slots. A peak reaching GABARIT_ACCORD and highest of
+// both patterns within a bit either side is a sync candidate, known one bit
+// late; a parabola through it gives the sub-sample timing. Slot boundaries
+// are rounded from the exact bit period, which need not be a whole number
+// of outputs.
+#define GABARIT_BITS 23         // Slots: preamble bits 2-15 and the frame sync
+#define GABARIT_ACCORD 0.8      // Smallest correlation coefficient
+
+// History kept from one chunk to the next: outputs for the span of a
+// candidate one bit and two outputs back, coefficients for its neighbours
+#define GABARIT_HISTO(portee, Nb) ((portee) + (Nb) + 2)
+#define GABARIT_VOISINS(Nb) (2 * (Nb) + 2)
+
+typedef struct {
+    uint32_t synchro;           // Frame sync, 9 bits
+    int somme;                  // Sum of the slot signs over their outputs
+    int n_bornes;               // Run boundaries of the slot pattern
+    int decalage[GABARIT_BITS + 1]; // Outputs back from the newest one
+    int poids[GABARIT_BITS + 1];    // Prefix-sum weight at each boundary
+} Gabarit;
+
+typedef struct {
+    int t;                      // Chunk index of the peak, < 0: previous chunk
+    int connu;                  // Chunk index of the output that confirms it
+    int gabarit;                // 0 normal, 1 self-test
+    SommeCorrel M;              // Matched output
+    double accord;              // Correlation coefficient
+    double delta;               // Sub-sample offset of the peak
+} Candidat;
+
+static const uint32_t synchros[2] = { 0x02F, 0x0D0 };
+
+// Slot j (oldest first) is +1 if bit j+2 equals bit j+1
+static int gabarit_signe(uint32_t synchro, int j) {
+    int b1 = (j + 1 <= 15) ? 1 : (int)(synchro >> (23 - j)) & 1;
+    int b2 = (j + 2 <= 15) ? 1 : (int)(synchro >> (22 - j)) & 1;
+    return (b1 == b2) ? 1 : -1;
+}
+
+// Outputs back from a peak to the end of the slot k slots older than the
+// last one, Tb outputs per bit
+static int gabarit_borne(int k, double Tb) {
+    return (int)lround(k * Tb);
+}
+
+// Slot j sums outputs p-B(23-j)+1 to p-B(22-j) of the peak p, B the bounds
+// above, so the prefix sum C[p+1-B(k)] weighs s[22-k] - s[23-k]
+static void gabarit_init(Gabarit *g, uint32_t synchro, double Tb) {
+    int k;
+
+    g->synchro = synchro;
+    g->somme = 0;
+    g->n_bornes = 0;
+    for (k = 0; k < GABARIT_BITS; k++) {
+        g->somme += gabarit_signe(synchro, GABARIT_BITS - 1 - k) *
+                    (gabarit_borne(k + 1, Tb) - gabarit_borne(k, Tb));
+    }
+    for (k = 0; k <= GABARIT_BITS; k++) {
+        int a = (k < GABARIT_BITS) ? gabarit_signe(synchro, GABARIT_BITS - 1 - k) : 0;
+        int b = (k > 0) ? gabarit_signe(synchro, GABARIT_BITS - k) : 0;
+        if (a != b) {
+            g->decalage[g->n_bornes] = gabarit_borne(k, Tb);
+            g->poids[g->n_bornes] = a - b;
+            g->n_bornes++;
+        }
+    }
+}
+
+// ===================================================
+// Energy gate
+// ===================================================
+// Between bursts the correlator only sees noise. The level over the last
+// few short blocks is compared with a slow average of past levels, the
+// window keeping its noise scatter well under the threshold so that a
+// burst near the decode limit still opens the gate: a burst changes
+// it one way or the other (up on an AM or SSB receiver, down on an FM
+// discriminator whose noise quiets on a carrier). While the level is
+// steady, samples only go into a short pre-trigger buffer; when it moves,
+// the buffer and what follows go through the correlator until the level
+// has settled again and no frame is in progress. The reference follows
+// the level only while closed; open for a while with no sync, the new
+// level is taken as the noise floor. Thresholds are left as they are
+// while closed: noise would have kept them up had it been correlated.
+#define PORTE_BLOC_S 0.010      // Level measurement block
+#define PORTE_FENETRE 4         // Blocks in the level window
+#define PORTE_AVANT_S 0.050     // Pre-trigger kept while closed
+#define PORTE_MAINTIEN_S 0.200  // Stays open this long after the last change
+#define PORTE_TAU_S 2.0         // Time constant of the reference level
+#define PORTE_REPRISE_S 1.0     // Open this long without sync: new reference
+
+typedef struct {
+    short *attente;     // Pre-trigger, then the current block while closed
+    int n_attente;
+    int avant;          // Pre-trigger length
+    int bloc;           // Block length
+    int dans_bloc;      // Samples of the current block seen so far
+    long long somme;    // Sum and sum of squares of the current block
+    long long carres;
+    long long sommes[PORTE_FENETRE]; // Same for the blocks of the window
+    long long carres_f[PORTE_FENETRE];
+    int n_fenetre;      // Blocks in the window so far
+    int i_fenetre;      // Slot of the next block
+    double reference;   // Slow average of window levels (dB)
+    double alpha;       // Reference averaging weight per block
+    int pret;           // Reference initialized
+    int ouverte;        // Correlator running
+    int maintien;       // Blocks left before closing
+    int maintien_max;
+    int sans_sync;      // Blocks open since opening or the last sync
+    int reprise;        // Blocks open without sync before a new reference
+    long long sautes;   // Samples never correlated
+} Porte;
+
+// Blocks and pre-trigger hold at least the 2*Nb samples that refill
+// the correlator window on opening
+static int porte_init(Porte *p, int f_ech, int Nb) {
+    p->bloc = (int)(PORTE_BLOC_S * f_ech);
+    if (p->bloc < 2 * Nb) p->bloc = 2 * Nb;
+    p->avant = (int)(PORTE_AVANT_S * f_ech);
+    if (p->avant < 2 * Nb) p->avant = 2 * Nb;
+    p->maintien_max = (int)ceil(PORTE_MAINTIEN_S / PORTE_BLOC_S);
+    p->alpha = PORTE_BLOC_S / PORTE_TAU_S;
+    p->reprise = (int)ceil(PORTE_REPRISE_S / PORTE_BLOC_S);
+    p->attente = malloc((p->avant + p->bloc) * sizeof(short));
+    if (!p->attente) return 1;
+    // Open for one hold time while the reference is set
+    p->n_attente = 0;
+    p->sans_sync = 0;
+    p->dans_bloc = 0;
+    p->somme = 0;
+    p->carres = 0;
+    p->n_fenetre = 0;
+    p->i_fenetre = 0;
+    p->pret = 0;
+    p->ouverte = 1;
+    p->maintien = p->maintien_max;
+    p->sautes = 0;
+    return 0;
+}
+
+static void porte_libere(Porte *p) {
+    free(p->attente);
+    p->attente = NULL;
+}
+
+// ===================================================
+// Demodulator state
+// ===================================================
+// Sync search and bit slicer of one threshold coefficient
+typedef struct {
+    double coeff;
+    double niveau;          // Starting level of max/min
+    int synchro;
+    int numBit;
+    int cpte;
+    int longueur_trame;
+    char etat;
+    Trame406 s;             // Bits sliced so far, numBit of them
+    SommeCorrel cumul[TRAME406_BITS_MAX]; // Y1 sums per bit slot of the current run
+    double marge[TRAME406_BITS_MAX]; // Same/different margin of each bit
+    ValeurCorrel max, min;
+    ValeurCorrel seuil0, seuil1;
+    double Tb;              // Bit period tracked over the frame
+    double duree_suivi;     // Runs measured since the sync and their bits,
+    int bits_suivi;         // which Tb follows
+    long long n_sync;       // Correlator sample where the preamble ended
+    double t_sync;          // Same, sub-sample
+    long long depuis;       // Correlator sample since which a sync is searched
+
+    // Frame waiting for the bank to decide on its burst
+    int pret;
+    int valide;             // Passes the BCH checks
+    long long fin;          // Correlator sample at its end
+    TrameDemod trame;
+} Decideur;
+
+struct Demod1G {
+    DemodConfig cfg;
+    demod_trame_cb cb;
+    void *utilisateur;
+
+    // Front end
+    int facteur;            // Decimation ratio
+    Decimateur decim;
+    FiltreEntree filtre;
+    short traite[BLOC_CORREL];
+
+    // Correlator
+    int Nb;                 // Samples per bit after decimation, truncated
+    double Tb;              // Same, exact
+    Correlateur correl;
+    ValeurCorrel *yh;       // GABARIT_HISTO outputs of history, then Yb
+    ValeurCorrel *Yb;       // Outputs of the current chunk
+    Porte porte;
+
+    // Sync matched filter
+    Gabarit gabarits[2];
+    int portee;             // Outputs spanned by the slots
+    SommeCorrel *cy;        // Prefix sums of yh and of its squares
+    SommeCorrel *ca;
+    int grossier;           // Integer build: yh shifted right by this when squared
+    SommeCorrel *mf[2];     // Matched outputs and correlation coefficients at
+    double *rr[2];          // peaks (0 elsewhere), GABARIT_VOISINS of the
+                            // previous chunk first
+    Candidat *cand;         // Sync candidates of the current chunk
+    int n_cand;
+
+    // Threshold bank, the configured coefficient first
+    Decideur dec[DEMOD_BANC_MAX];
+    int n_dec;
+
+    long long n_entree;     // Input samples consumed
+    long long n_traite;     // Samples through the correlator
+};
+
+void demod_config_defaut(DemodConfig *cfg, int f_ech) {
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->f_ech = f_ech;
+    cfg->bauds = 400;
+    cfg->coeff = 100;
+    cfg->niveau = NIVEAU_INITIAL;
+    cfg->decimation = 1;
+    cfg->f_passe_haut = PASSE_HAUT_DEFAUT;
+    cfg->f_passe_bas = PASSE_BAS_DEFAUT;
+    cfg->demi_vie = DEMI_VIE_DEFAUT;
+    cfg->porte = 1;
+    cfg->porte_seuil = PORTE_SEUIL_DB;
+}
+
+// Back to sync search, thresholds and correlator untouched
+static void demod_raz_trame(Decideur *h) {
+    h->etat = '-';
+    h->numBit = 0;
+    h->synchro = 0;
+    h->cpte = 0;
+    h->longueur_trame = 144;
+    h->pret = 0;
+    trame406_efface(&h->s, 0);
+    memset(h->cumul, 0, sizeof(h->cumul));
+}
+
+// The matched filter restarts on silence
+static void gabarit_raz(Demod1G *d) {
+    int g;
+
+    memset(d->yh, 0, GABARIT_HISTO(d->portee, d->Nb) * sizeof(ValeurCorrel));
+    for (g = 0; g < 2; g++) {
+        memset(d->mf[g], 0, GABARIT_VOISINS(d->Nb) * sizeof(SommeCorrel));
+        memset(d->rr[g], 0, GABARIT_VOISINS(d->Nb) * sizeof(double));
+    }
+    d->n_cand = 0;
+}
+
+// Level given for Y1 (--M4) in correlator output units
+static ValeurCorrel demod_unites(const Demod1G *d, double niveau) {
+#ifdef DEMOD_ENTIER
+    double v = ldexp(niveau * 4 * d->Nb, -d->correl.decalage);
+    return (v >= INT32_MAX) ? INT32_MAX : (ValeurCorrel)v;
+#else
+    (void)d;
+    return niveau;
+#endif
+}
+
+// Threshold of a peak level. Integer outputs are compared with the
+// quotient truncated towards zero, which is crossed on the same outputs
+// as the exact one in both directions.
+static inline ValeurCorrel demod_seuil(ValeurCorrel niveau, double coeff) {
+#ifdef DEMOD_ENTIER
+    double v = niveau / coeff;
+    return (v >= INT32_MAX) ? INT32_MAX : (v <= INT32_MIN) ? INT32_MIN : (ValeurCorrel)v;
+#else
+    return niveau / coeff;
+#endif
+}
+
+void demod_reinit(Demod1G *d) {
+    int r;
+
+    for (r = 0; r < d->n_dec; r++) {
+        Decideur *h = &d->dec[r];
+        ValeurCorrel Max = demod_unites(d, h->niveau);
+        ValeurCorrel Min = -Max;
+        demod_raz_trame(h);
+        h->depuis = 0;
+        h->max = Max;
+        h->min = Min;
+        h->seuil0 = demod_seuil(Min, h->coeff);
+        h->seuil1 = demod_seuil(Max, h->coeff);
+    }
+    correl_raz(&d->correl);
+    gabarit_raz(d);
+}
+
+Demod1G *demod_cree(const DemodConfig *cfg, demod_trame_cb cb, void *utilisateur) {
+    Demod1G *d;
+    int facteur = decim_facteur(cfg->f_ech, cfg->bauds, cfg->decimation);
+    double Tb = (double)cfg->f_ech / facteur / cfg->bauds;
+    int Nb = (int)Tb;
+    int i, r, histo;
+
+    if (Nb < 2) {
+        fprintf(stderr, "Sample rate too low: %d Hz\n", cfg->f_ech / facteur);
+        return NULL;
+    }
+
+    d = calloc(1, sizeof(*d));
+    if (!d) return NULL;
+    d->cfg = *cfg;
+    d->cb = cb;
+    d->utilisateur = utilisateur;
+    d->facteur = facteur;
+    d->Nb = Nb;
+    d->Tb = Tb;
+    d->portee = gabarit_borne(GABARIT_BITS, Tb);
+    histo = GABARIT_HISTO(d->portee, Nb);
+
+    // Bank: the configured coefficient, then the others once each
+    d->dec[0].coeff = cfg->coeff;
+    d->dec[0].niveau = cfg->niveau;
+    d->n_dec = 1;
+    for (i = 0; i < cfg->n_banc && d->n_dec < DEMOD_BANC_MAX; i++) {
+        double c = cfg->banc[i];
+        double v = (cfg->banc_niveau[i] > 0.0) ? cfg->banc_niveau[i] : cfg->niveau;
+        for (r = 0; r < d->n_dec && (d->dec[r].coeff != c || d->dec[r].niveau != v); r++) {}
+        if (r < d->n_dec || c <= 0.0) continue;
+        d->dec[d->n_dec].coeff = c;
+        d->dec[d->n_dec].niveau = v;
+        d->n_dec++;
+    }
+
+    noyaux_init();
+    decim_init(&d->decim, facteur);
+    gabarit_init(&d->gabarits[0], synchros[0], Tb);
+    gabarit_init(&d->gabarits[1], synchros[1], Tb);
+    d->yh = malloc((histo + BLOC_CORREL) * sizeof(ValeurCorrel));
+    d->cy = malloc((histo + BLOC_CORREL + 1) * sizeof(SommeCorrel));
+    d->ca = malloc((histo + BLOC_CORREL + 1) * sizeof(SommeCorrel));
+    // Squares of 32-bit outputs summed over a chunk and its history stay
+    // within 63 bits once shifted right by grossier
+    for (d->grossier = 0; (histo + BLOC_CORREL) >> (2 * d->grossier + 1); d->grossier++) {}
+    for (i = 0; i < 2; i++) {
+        d->mf[i] = malloc((GABARIT_VOISINS(Nb) + BLOC_CORREL) * sizeof(SommeCorrel));
+        d->rr[i] = malloc((GABARIT_VOISINS(Nb) + BLOC_CORREL) * sizeof(double));
+    }
+    d->cand = malloc(BLOC_CORREL * sizeof(Candidat));
+    if (!d->yh || !d->cy || !d->ca || !d->mf[0] || !d->mf[1] || !d->rr[0] || !d->rr[1] ||
+        !d->cand ||
+        correl_init(&d->correl, Nb) != 0 ||
+        (cfg->porte && porte_init(&d->porte, cfg->f_ech / facteur, Nb) != 0)) {
+        fprintf(stderr, "Memory allocation error\n");
+        demod_detruit(d);
+        return NULL;
+    }
+    if (cfg->filtre) {
+        int err = filtre_init(&d->filtre, cfg->f_ech, facteur,
+                              cfg->f_passe_haut, cfg->f_passe_bas);
+        if (err == FILTRE_ERR_COINS) {
+            fprintf(stderr, "Invalid filter corners %.0f-%.0f Hz (output rate %d Hz)\n",
+                    cfg->f_passe_haut, cfg->f_passe_bas, cfg->f_ech / facteur);
+        } else if (err != 0) {
+            fprintf(stderr, "Memory allocation error\n");
+        }
+        if (err != 0) {
+            demod_detruit(d);
+            return NULL;
+        }
+    }
+    d->Yb = d->yh + histo;
+    demod_reinit(d);
+    return d;
+}
+
+void demod_detruit(Demod1G *d) {
+    int i;
+
+    if (!d) return;
+    correl_libere(&d->correl);
+    porte_libere(&d->porte);
+    filtre_libere(&d->filtre);
+    free(d->yh);
+    free(d->cy);
+    free(d->ca);
+    for (i = 0; i < 2; i++) {
+        free(d->mf[i]);
+        free(d->rr[i]);
+    }
+    free(d->cand);
+    free(d);
+}
+
+long long demod_position(const Demod1G *d) {
+    return d->n_entree;
+}
+
+double demod_charge(const Demod1G *d) {
+    long long total = d->n_traite + d->porte.n_attente;
+    if (total == 0) return 1.0;
+    return 1.0 - (double)d->porte.sautes / total;
+}
+
+// A frame is being sliced by some coefficient of the bank
+static int demod_en_trame(const Demod1G *d) {
+    int r;
+    for (r = 0; r < d->n_dec; r++) {
+        if (d->dec[r].synchro && !d->dec[r].pret) return 1;
+    }
+    return 0;
+}
+
+// ===================================================
+// Sync search and bit slicer
+// ===================================================
+// In continuous mode max/min carry over from one frame to the next. While
+// no burst is in progress they decay towards their starting level, so a
+// strong beacon does not blind the decoder to weaker ones for good. The
+// decay is applied once per call, which keeps thresholds constant within
+// the span handed to the event-search kernel.
+static void demod_decroissance(const Demod1G *d, Decideur *h, int n) {
+    ValeurCorrel niveau;
+    double f;
+
+    if (!d->cfg.continu || d->cfg.demi_vie <= 0.0 || h->synchro) {
+        return;
+    }
+    f = pow(0.5, n / (d->cfg.demi_vie * d->cfg.f_ech / d->facteur));
+    niveau = demod_unites(d, h->niveau);
+    if (h->max * f > niveau) {
+        h->max = (ValeurCorrel)(h->max * f);
+        h->seuil1 = demod_seuil(h->max, h->coeff);
+    }
+    if (h->min * f < -niveau) {
+        h->min = (ValeurCorrel)(h->min * f);
+        h->seuil0 = demod_seuil(h->min, h->coeff);
+    }
+}
+
+// Soft decisions. Each bit is sliced as the same as or the opposite of the
+// previous one, from the sign of Y1 over a run between two transitions.
+// Y1 is summed per bit slot of the run; a slot's mean against the peak on
+// its side is the margin of that decision. A bit alone is wrong when the
+// decisions on both of its sides are, so its reliability is their mean.
+static inline int demod_case(int i) {
+    return (i < TRAME406_BITS_MAX) ? i : TRAME406_BITS_MAX - 1;
+}
+
+// Add n outputs, the first one at run sample cpte (0-indexed). Run sample
+// j falls in slot (int)(j / Tb); the slot is found once per bit, and its
+// end moved onto the first sample the product puts past it.
+static void demod_cumule(Decideur *h, const ValeurCorrel *Y, int n, int cpte) {
+    const double f = 1.0 / h->Tb;
+    int k = 0;
+
+    while (k < n) {
+        const int i = (int)((cpte + k) * f);
+        SommeCorrel *c = &h->cumul[demod_case(i)];
+        int fin = n;
+        if (i + 1 < TRAME406_BITS_MAX) {
+            fin = (int)ceil((i + 1) * h->Tb) - cpte;
+            if (fin <= k) fin = k + 1;
+            while (fin > k + 1 && (int)((cpte + fin - 1) * f) > i) fin--;
+            while (fin < n && (int)((cpte + fin) * f) <= i) fin++;
+            if (fin > n) fin = n;
+        }
+        for (; k < fin; k++) *c += Y[k];
+    }
+}
+
+// Margin of bit i of a run, niveau the peak level on the run's side
+static inline double demod_marge(const Decideur *h, int i, ValeurCorrel niveau) {
+    return h->cumul[demod_case(i)] / (h->Tb * niveau);
+}
+
+// A run of duree samples ended: clear its slots
+static void demod_fin_run(Decideur *h, int duree) {
+    const double f = 1.0 / h->Tb;
+    memset(h->cumul, 0, (demod_case((int)(duree * f)) + 1) * sizeof(SommeCorrel));
+}
+
+// Bit timing. The slicer re-times on every transition, so only the bit
+// period has to be known: a run is cut into as many bits as it lasts
+// periods, rounded. Beacons are allowed 1% off the nominal rate and the
+// sample rate need not be a multiple of it, so the period follows the
+// frame: the mean over its runs, weighed against SUIVI_BITS bits at the
+// nominal period. Rising and falling transitions cross the thresholds with
+// different delays, which cancel between consecutive runs but not over the
+// first one after the sync, which does not start on a crossing; it is left
+// out (bits_suivi < 0). So are runs far from a whole number of periods,
+// whose bit count may be wrong.
+#define SUIVI_BITS 16
+#define SUIVI_ECART 0.02        // Largest deviation from the nominal period
+#define SUIVI_TOLERANCE 0.25    // Of a period, off a whole number of them
+
+static void demod_suivi(const Demod1G *d, Decideur *h, int duree, int bits) {
+    double Tb;
+
+    if (h->bits_suivi < 0) {
+        h->bits_suivi = 0;
+        return;
+    }
+    if (bits <= 0 || fabs(duree - bits * h->Tb) > SUIVI_TOLERANCE * h->Tb) return;
+    h->duree_suivi += duree;
+    h->bits_suivi += bits;
+    Tb = (SUIVI_BITS * d->Tb + h->duree_suivi) / (SUIVI_BITS + h->bits_suivi);
+    if (Tb > d->Tb * (1.0 + SUIVI_ECART)) Tb = d->Tb * (1.0 + SUIVI_ECART);
+    if (Tb < d->Tb * (1.0 - SUIVI_ECART)) Tb = d->Tb * (1.0 - SUIVI_ECART);
+    h->Tb = Tb;
+}
+
+// Matched outputs and sync candidates of the n outputs in Yb
+static void demod_gabarits(Demod1G *d, int n) {
+    const int Nb = d->Nb;
+    const int H = d->portee;
+    const int Y = GABARIT_HISTO(H, Nb);
+    const int V = GABARIT_VOISINS(Nb);
+    const ValeurCorrel *y = d->yh;
+    SommeCorrel *C = d->cy, *A = d->ca;
+    int i, g, b, t;
+
+    C[0] = 0;
+    A[0] = 0;
+    for (i = 0; i < Y + n; i++) {
+        C[i + 1] = C[i] + y[i];
+#ifdef DEMOD_ENTIER
+        A[i + 1] = A[i] + (SommeCorrel)(y[i] >> d->grossier) * (y[i] >> d->grossier);
+#else
+        A[i + 1] = A[i] + y[i] * y[i];
+#endif
+    }
+    for (g = 0; g < 2; g++) {
+        const Gabarit *gab = &d->gabarits[g];
+        SommeCorrel *restrict M = d->mf[g] + V;
+        for (t = 0; t < n; t++) M[t] = 0;
+        for (b = 0; b < gab->n_bornes; b++) {
+            const SommeCorrel *restrict c = C + Y + 1 - gab->decalage[b];
+            const SommeCorrel w = gab->poids[b];
+            for (t = 0; t < n; t++) M[t] += w * c[t];
+        }
+    }
+
+    // Coefficients at the peaks, the last output waiting for the next chunk;
+    // the threshold is tested squared first, as it rarely passes
+    for (g = 0; g < 2; g++) {
+        const SommeCorrel *M = d->mf[g] + V;
+#ifdef DEMOD_ENTIER
+        // Numerator times H, exact; the coefficient itself is only worked
+        // out in floating point at the peaks that pass
+        const int Sw = d->gabarits[g].somme;
+        const double Dw = H - (double)Sw * Sw / H;
+        const double echelle = ldexp(1.0, 2 * d->grossier);
+        for (t = -1; t < n - 1; t++) {
+            const SommeCorrel Sy = C[Y + t + 1] - C[Y + t + 1 - H];
+            const SommeCorrel num = H * M[t] - Sw * Sy;
+            double r = 0.0;
+            if (num > 0 && M[t] > M[t - 1] && M[t] >= M[t + 1]) {
+                const double Syy = (A[Y + t + 1] - A[Y + t + 1 - H]) * echelle -
+                                   (double)Sy * Sy / H;
+                const double nr = (double)num / H;
+                if (Syy > 0.0 && nr * nr >= GABARIT_ACCORD * GABARIT_ACCORD * Dw * Syy) {
+                    r = nr / sqrt(Dw * Syy);
+                }
+            }
+            d->rr[g][V + t] = r;
+        }
+#else
+        const double Sw = d->gabarits[g].somme;
+        const double Dw = H - Sw * Sw / H;
+        for (t = -1; t < n - 1; t++) {
+            const double Sy = C[Y + t + 1] - C[Y + t + 1 - H];
+            const double Syy = A[Y + t + 1] - A[Y + t + 1 - H] - Sy * Sy / H;
+            const double num = M[t] - Sw * Sy / H;
+            double r = 0.0;
+            if (num > 0.0 && Syy > 0.0 &&
+                num * num >= GABARIT_ACCORD * GABARIT_ACCORD * Dw * Syy &&
+                M[t] > M[t - 1] && M[t] >= M[t + 1]) {
+                r = num / sqrt(Dw * Syy);
+            }
+            d->rr[g][V + t] = r;
+        }
+#endif
+    }
+
+    // Candidates highest within a bit either side, earlier ones winning ties
+    d->n_cand = 0;
+    for (t = -Nb - 1; t < n - 1 - Nb; t++) {
+        for (g = 0; g < 2; g++) {
+            const double r = d->rr[g][V + t];
+            Candidat *k = &d->cand[d->n_cand];
+            const SommeCorrel *M = d->mf[g] + V;
+            double courbure;
+            int q, h, pic = 1;
+            if (r <= 0.0) continue;
+            for (h = 0; h < 2 && pic; h++) {
+                for (q = t - Nb; q <= t + Nb && pic; q++) {
+                    const double v = d->rr[h][V + q];
+                    if (v > r || (v == r && (q < t || (q == t && h < g)))) pic = 0;
+                }
+            }
+            if (!pic) continue;
+            k->t = t;
+            k->connu = t + Nb + 1;
+            k->gabarit = g;
+            k->accord = r;
+            k->M = M[t];
+            courbure = (double)(M[t - 1] - 2 * M[t] + M[t + 1]);
+            k->delta = (courbure < 0.0) ? 0.5 * (double)(M[t - 1] - M[t + 1]) / courbure : 0.0;
+            d->n_cand++;
+        }
+    }
+}
+
+// Chunk done: keep the history the next one needs
+static void demod_gabarits_suite(Demod1G *d, int n) {
+    const int Y = GABARIT_HISTO(d->portee, d->Nb);
+    const int V = GABARIT_VOISINS(d->Nb);
+    int g;
+
+    memmove(d->yh, d->yh + n, Y * sizeof(ValeurCorrel));
+    for (g = 0; g < 2; g++) {
+        memmove(d->mf[g], d->mf[g] + n, V * sizeof(SommeCorrel));
+        memmove(d->rr[g], d->rr[g] + n, V * sizeof(double));
+    }
+}
+
+// Sync on candidate k: bits 1-24 from the pattern. Bits of the run the
+// peak falls in are left to the slicer, which writes them on the run's
+// closing transition as usual.
+static void demod_accroche(const Demod1G *d, Decideur *h, const Candidat *k, int t) {
+    const Gabarit *g = &d->gabarits[k->gabarit];
+    const int p = k->t;
+    int j, debut;
+
+    trame406_pose(&h->s, 0, 15, 0x7FFF);
+    trame406_pose(&h->s, 15, 9, g->synchro);
+    for (j = 0; j < GABARIT_BITS; j++) {
+        const int long_case = gabarit_borne(GABARIT_BITS - j, d->Tb) -
+                              gabarit_borne(GABARIT_BITS - 1 - j, d->Tb);
+        const ValeurCorrel *Y = d->Yb + p - gabarit_borne(GABARIT_BITS - j, d->Tb) + 1;
+        const ValeurCorrel niveau = (gabarit_signe(g->synchro, j) > 0) ? h->max : h->min;
+        SommeCorrel B = 0;
+        int a;
+        for (a = 0; a < long_case; a++) B += Y[a];
+        h->marge[j + 1] = B / (long_case * (double)niveau);
+    }
+    // First bit of the last run (1-indexed bits, 24 the last of the sync)
+    for (debut = 24; debut > 2 && gabarit_signe(g->synchro, debut - 3) ==
+                                  gabarit_signe(g->synchro, debut - 2); debut--) {}
+    h->numBit = debut - 1;
+    h->etat = (gabarit_signe(g->synchro, debut - 2) > 0) ? '1' : '0';
+    h->cpte = gabarit_borne(24 - h->numBit, d->Tb) + (t - p - 1);
+    h->Tb = d->Tb;
+    h->duree_suivi = 0.0;
+    h->bits_suivi = -1;
+    memset(h->cumul, 0, sizeof(h->cumul));
+    demod_cumule(h, d->Yb + t - h->cpte, h->cpte, 0);
+    h->synchro = 1;
+    h->n_sync = d->n_traite + p - gabarit_borne(9, d->Tb);
+    h->t_sync = d->n_traite + p + k->delta - 9 * d->Tb;
+}
+
+// Runs over correlator outputs t to n-1 of the chunk. Stops early when a
+// frame is complete and returns the index of the next output.
+static int demod_machine(const Demod1G *d, Decideur *h, int t, int n) {
+    const ValeurCorrel *Yb = d->Yb;
+    const double coeff = h->coeff;
+    int numBit = h->numBit;
+    char etat = h->etat;
+    int cpte = h->cpte;
+    int synchro = h->synchro;
+    int longueur_trame = h->longueur_trame;
+    ValeurCorrel max = h->max;
+    ValeurCorrel min = h->min;
+    ValeurCorrel seuil0 = h->seuil0;
+    ValeurCorrel seuil1 = h->seuil1;
+    Trame406 *s = &h->s;
+    // With a bank, only the configured coefficient reports its syncs
+    const int verbeux = d->cfg.verbeux && h == &d->dec[0];
+    int c = 0;
+    ValeurCorrel Y1;
+
+    while (c < d->n_cand && (d->cand[c].connu < t ||
+                             d->n_traite + d->cand[c].t + 1 < h->depuis)) c++;
+
+    while (t < n && numBit < longueur_trame) {
+        // Skip samples that leave max/min and the state unchanged
+        ValeurCorrel haut = seuil1, bas = min;
+        int m = n - t;
+        int saut, reste;
+
+        if (synchro == 1) {
+            if (numBit > 24 && !trame406_bit(s, 24)) {
+                longueur_trame = 112;
+            }
+            if (etat == '1') {
+                haut = max;
+                bas = seuil0;
+            }
+            // Once the current run covers the rest of the frame, write
+            // the bits the closing transition would write; after the
+            // last bit it may only come with the next burst, whose sync
+            // would then be lost
+            reste = (int)floor((longueur_trame - numBit - 0.5) * h->Tb) + 1 - cpte;
+            if (reste <= 0) {
+                int i = 0;
+                while (numBit < longueur_trame) {
+                    if (etat == '1') {
+                        trame406_met(s, numBit, trame406_bit(s, numBit - 1));
+                    } else {
+                        trame406_met(s, numBit, !trame406_bit(s, numBit - 1));
+                    }
+                    h->marge[numBit] = demod_marge(h, i++, etat == '1' ? max : min);
+                    numBit++;
+                }
+                break;
+            }
+            if (m > reste) m = reste;
+        } else {
+            // Sync search: only max/min move until the next candidate is
+            // known, then slicing resumes right after its peak
+            haut = max;
+            if (c < d->n_cand && d->cand[c].connu == t) {
+                const Candidat *k = &d->cand[c++];
+                // The pattern must also stand above this coefficient's threshold
+                if (k->M < (SommeCorrel)d->portee * seuil1) continue;
+                t = k->t + 1;
+                h->max = max;
+                h->min = min;
+                demod_accroche(d, h, k, t);
+                numBit = h->numBit;
+                etat = h->etat;
+                cpte = h->cpte;
+                synchro = 1;
+                if (verbeux) {
+                    printf("Sync found: match %.2f%s\n", k->accord,
+                           k->gabarit ? ", self-test frame sync" : "");
+                }
+                continue;
+            }
+            if (c < d->n_cand && d->cand[c].connu - t < m) m = d->cand[c].connu - t;
+        }
+
+        saut = noyaux.cherche(Yb + t, m, haut, bas);
+        if (synchro == 1) {
+            demod_cumule(h, Yb + t, saut, cpte);
+            cpte += saut;
+        }
+        t += saut;
+        if (t == n || saut == m) continue;
+
+        Y1 = Yb[t++];
+
+        if (Y1 > max) {
+            max = Y1;
+            seuil1 = demod_seuil(max, coeff);
+        }
+        if (Y1 < min) {
+            min = Y1;
+            seuil0 = demod_seuil(min, coeff);
+        }
+        if (synchro == 0) continue;
+
+        demod_cumule(h, &Y1, 1, cpte);
+        cpte++;
+
+        if (numBit > 24 && !trame406_bit(s, 24)) {
+            longueur_trame = 112;
+        }
+
+        if (Y1 > seuil1) {
+            if (etat == '0') {
+                int i = 0, duree = cpte;
+                double reste = cpte - h->Tb / 2;
+                etat = '1';
+                while ((reste > 0) && (numBit < longueur_trame)) {
+                    trame406_met(s, numBit, !trame406_bit(s, numBit - 1));
+                    h->marge[numBit] = demod_marge(h, i++, min);
+                    numBit++;
+                    reste -= h->Tb;
+                }
+                demod_fin_run(h, duree);
+                demod_suivi(d, h, duree, i);
+                cpte = 0;
+            }
+        } else if (Y1 < seuil0) {
+            if (etat == '1') {
+                int i = 0, duree = cpte;
+                double reste = cpte - h->Tb / 2;
+                etat = '0';
+                while ((reste > 0) && (numBit < 149)) {
+                    trame406_met(s, numBit, trame406_bit(s, numBit - 1));
+                    h->marge[numBit] = demod_marge(h, i++, max);
+                    numBit++;
+                    reste -= h->Tb;
+                }
+                demod_fin_run(h, duree);
+                demod_suivi(d, h, duree, i);
+                cpte = 0;
+            }
+        }
+    }
+
+    h->numBit = numBit;
+    h->etat = etat;
+    h->cpte = cpte;
+    h->synchro = synchro;
+    h->longueur_trame = longueur_trame;
+    h->max = max;
+    h->min = min;
+    h->seuil0 = seuil0;
+    h->seuil1 = seuil1;
+    return t;
+}
+
+// Bits 1-15 are the sync itself; past that, the mean of the margins on
+// both sides of each bit, scaled so that the frame's mean is 128
+static void demod_fiabilite(const Decideur *h, uint8_t *fiabilite) {
+    const int L = h->longueur_trame;
+    double r[TRAME406_BITS_MAX];
+    double somme = 0.0;
+    int k;
+
+    for (k = 15; k < L; k++) {
+        r[k] = 0.5 * (h->marge[k] + ((k + 1 < L) ? h->marge[k + 1] : h->marge[k]));
+        somme += r[k];
+    }
+    memset(fiabilite, 255, TRAME406_BITS_MAX);
+    for (k = 15; k < L; k++) {
+        double v = (somme > 0.0) ? 128.0 * r[k] * (L - 15) / somme : 0.0;
+        fiabilite[k] = (v <= 0.0) ? 0 : (v >= 255.0) ? 255 : (uint8_t)v;
+    }
+}
+
+// ===================================================
+// Threshold bank
+// ===================================================
+// Every coefficient slices the same correlator output. A completed frame
+// waits until its burst is decided: at once if it is a codeword, allowing
+// one bit error per BCH code (miscorrecting a noise frame into a codeword
+// is then unlikely, where three errors would pass one in twenty), otherwise
+// when no coefficient is still slicing the burst. Syncs less than the frame
+// sync apart belong to the same burst. A single coefficient decides on the
+// spot, as the slicer always did.
+#define BANC_FENETRE_BITS 24
+#define BANC_ERREURS_MAX 1
+
+static int demod_trame_valide(const Trame406 *t) {
+    Trame406 c = *t;
+    int e = bch1_corrige(&c);
+
+    if (e < 0 || e > BANC_ERREURS_MAX) return 0;
+    if (c.longueur == 144) {
+        e = bch2_corrige(&c);
+        if (e < 0 || e > BANC_ERREURS_MAX) return 0;
+    }
+    return 1;
+}
+
+// Frame complete at correlator sample fin: park it for the decision
+static void demod_termine(Demod1G *d, Decideur *h, long long fin) {
+    TrameDemod *trame = &h->trame;
+
+    // The slicer may run a few bits past a short frame
+    trame->bits = h->s;
+    trame406_tronque(&trame->bits, h->longueur_trame);
+    demod_fiabilite(h, trame->fiabilite);
+    trame->ech_sync = h->n_sync * d->facteur;
+    trame->t_sync = h->t_sync * d->facteur;
+    trame->ech = fin * d->facteur;
+    h->fin = fin;
+    h->depuis = fin;
+    h->valide = (d->n_dec > 1) ? demod_trame_valide(&trame->bits) : 1;
+    h->pret = 1;
+}
+
+static int demod_meme_salve(const Demod1G *d, const Decideur *a, const Decideur *b) {
+    long long ecart = a->n_sync - b->n_sync;
+    return (ecart < 0 ? -ecart : ecart) < (long long)BANC_FENETRE_BITS * d->Nb;
+}
+
+// Hand a frame to the callback
+static void demod_emet(Demod1G *d, const Decideur *h) {
+    if (d->cfg.verbeux) {
+        printf("%s frame captured (%d bits)", h->longueur_trame == 112 ? "Short" : "Long",
+               h->longueur_trame);
+        if (d->n_dec > 1) printf(", threshold coefficient %.0f, level %.0f", h->coeff, h->niveau);
+        printf("\n");
+    }
+    if (d->cb) d->cb(&h->trame, d->utilisateur);
+}
+
+// Decide the burst of the earliest parked frame if it can be. With force,
+// frames still being sliced are not waited for. Other coefficients than
+// the configured one only contribute frames that pass the checks: low
+// coefficients sync on noise. Returns 1 with the correlator sample where
+// the frame was decided in *quand, 0 if the burst was dropped, -1 if
+// there is nothing to decide yet.
+static int demod_decide(Demod1G *d, int force, long long *quand) {
+    Decideur *premier = NULL, *choix = NULL;
+    int r;
+
+    for (r = 0; r < d->n_dec; r++) {
+        Decideur *h = &d->dec[r];
+        if (h->pret && (!premier || h->n_sync < premier->n_sync)) premier = h;
+    }
+    if (!premier) return -1;
+
+    for (r = 0; r < d->n_dec && !(choix && choix->valide); r++) {
+        Decideur *h = &d->dec[r];
+        if (h->pret && demod_meme_salve(d, h, premier) && (h->valide || r == 0)) choix = h;
+    }
+    if (!(choix && choix->valide) && !force) {
+        // Wait for the others still slicing this burst
+        for (r = 0; r < d->n_dec; r++) {
+            Decideur *h = &d->dec[r];
+            if (h->synchro && !h->pret && demod_meme_salve(d, h, premier)) return -1;
+        }
+    }
+
+    if (choix) {
+        *quand = choix->fin;
+        demod_emet(d, choix);
+    }
+    // No sync search goes back into the burst
+    for (r = 0; r < d->n_dec; r++) {
+        Decideur *h = &d->dec[r];
+        if ((h->pret || h->synchro) && demod_meme_salve(d, h, premier)) {
+            demod_raz_trame(h);
+            if (h->depuis < premier->fin) h->depuis = premier->fin;
+        }
+    }
+    return choix ? 1 : 0;
+}
+
+int demod_vide(Demod1G *d) {
+    long long quand;
+    int trames = 0;
+    int r;
+
+    while ((r = demod_decide(d, 1, &quand)) >= 0) trames += r;
+    return trames;
+}
+
+// ===================================================
+// Block processing
+// ===================================================
+// Correlate and slice k samples at the correlator rate. Each coefficient
+// slices the chunk in turn, up to the end or to a parked frame; after a
+// decision all of them go round again from where they stopped.
+static int demod_traite(Demod1G *d, const short *x, int k) {
+    int trames = 0;
+    int pos = 0;
+
+    while (pos < k) {
+        const int n = k - pos;
+        const long long base = d->n_traite;
+        int t[DEMOD_BANC_MAX] = { 0 };
+        long long quand = -1;
+        int r, q, issue;
+
+        correl_bloc(&d->correl, x + pos, n, d->Yb);
+        demod_gabarits(d, n);
+        for (r = 0; r < d->n_dec && quand < 0; r++) {
+            Decideur *h = &d->dec[r];
+            while (t[r] < n && !h->pret) {
+                demod_decroissance(d, h, n - t[r]);
+                t[r] = demod_machine(d, h, t[r], n);
+                if (h->numBit < h->longueur_trame) continue;
+                demod_termine(d, h, base + t[r]);
+                issue = demod_decide(d, 0, &quand);
+                if (issue < 0) break;
+                if (issue == 0) {
+                    // Burst dropped: the coefficients it held go on
+                    quand = -1;
+                    r = -1;
+                    break;
+                }
+                trames++;
+                // The rest of the chunk is correlated again from a clean state
+                if (!d->cfg.continu) break;
+                // Next sync search starts on the very next sample; the
+                // coefficients behind skip what is left of the burst
+                for (q = 0; q < d->n_dec; q++) {
+                    if (!d->dec[q].pret && base + t[q] < quand) {
+                        demod_raz_trame(&d->dec[q]);
+                        d->dec[q].depuis = quand;
+                        t[q] = (int)(quand - base);
+                    }
+                }
+                quand = -1;
+                r = -1;
+                break;
+            }
+        }
+        if (quand >= 0) {
+            demod_reinit(d);
+            pos += (int)(quand - base);
+            d->n_traite = quand;
+        } else {
+            demod_gabarits_suite(d, n);
+            pos += n;
+            d->n_traite += n;
+        }
+    }
+    return trames;
+}
+
+// Level of the finished block against the reference; opens the gate
+// (correlating the pre-trigger first) or closes it
+static int porte_decide(Demod1G *d) {
+    Porte *p = &d->porte;
+    long long somme = 0, carres = 0;
+    double moy, variance, niveau;
+    int trames = 0;
+    int i;
+
+    p->sommes[p->i_fenetre] = p->somme;
+    p->carres_f[p->i_fenetre] = p->carres;
+    p->i_fenetre = (p->i_fenetre + 1) % PORTE_FENETRE;
+    if (p->n_fenetre < PORTE_FENETRE) p->n_fenetre++;
+    for (i = 0; i < p->n_fenetre; i++) {
+        somme += p->sommes[i];
+        carres += p->carres_f[i];
+    }
+    moy = (double)somme / (p->n_fenetre * p->bloc);
+    variance = (double)carres / (p->n_fenetre * p->bloc) - moy * moy;
+    niveau = 10.0 * log10(variance + 1.0);
+
+    if (!p->pret) {
+        p->reference = niveau;
+        p->pret = 1;
+    }
+    if (!p->ouverte) {
+        p->reference += p->alpha * (niveau - p->reference);
+    } else if (demod_en_trame(d)) {
+        p->sans_sync = 0;
+    } else if (++p->sans_sync > p->reprise) {
+        p->reference = niveau;
+    }
+    if (fabs(niveau - p->reference) > d->cfg.porte_seuil || demod_en_trame(d)) {
+        p->maintien = p->maintien_max;
+    }
+
+    if (p->maintien > 0) {
+        p->maintien--;
+        if (!p->ouverte) {
+            // The correlator history predates the gap: its window is
+            // refilled from the start of the pre-trigger
+            int amorce = 2 * d->Nb;
+            p->ouverte = 1;
+            p->sans_sync = 0;
+            correl_amorce(&d->correl, p->attente);
+            gabarit_raz(d);
+            d->n_traite += amorce;
+            for (i = amorce; i < p->n_attente; i += BLOC_CORREL) {
+                int m = p->n_attente - i;
+                if (m > BLOC_CORREL) m = BLOC_CORREL;
+                trames += demod_traite(d, p->attente + i, m);
+            }
+            p->n_attente = 0;
+        }
+    } else if (p->ouverte) {
+        // A sync search cannot run across the gap: frames waiting for
+        // their burst to be decided go now
+        p->ouverte = 0;
+        trames += demod_vide(d);
+        for (i = 0; i < d->n_dec; i++) demod_raz_trame(&d->dec[i]);
+    }
+
+    p->dans_bloc = 0;
+    p->somme = 0;
+    p->carres = 0;
+    return trames;
+}
+
+// Correlate k samples, or only buffer them while the gate is closed
+static int porte_alimente(Demod1G *d, const short *x, int k) {
+    Porte *p = &d->porte;
+    int trames = 0;
+
+    while (k > 0) {
+        int m = p->bloc - p->dans_bloc;
+        long long somme, carres;
+
+        if (m > k) m = k;
+        noyaux.moments(x, m, &somme, &carres);
+        p->somme += somme;
+        p->carres += carres;
+        p->dans_bloc += m;
+
+        if (p->ouverte) {
+            trames += demod_traite(d, x, m);
+        } else {
+            memcpy(p->attente + p->n_attente, x, m * sizeof(short));
+            p->n_attente += m;
+        }
+        x += m;
+        k -= m;
+        if (p->dans_bloc < p->bloc) continue;
+
+        trames += porte_decide(d);
+        if (!p->ouverte && p->n_attente > p->avant) {
+            // Samples leaving the pre-trigger are skipped for good
+            int sortie = p->n_attente - p->avant;
+            d->n_traite += sortie;
+            p->sautes += sortie;
+            p->n_attente = p->avant;
+            memmove(p->attente, p->attente + sortie, p->avant * sizeof(short));
+        }
+    }
+    return trames;
+}
+
+int demod_alimente(Demod1G *d, const short *ech, int n) {
+    int trames = 0;
+
+    while (n > 0) {
+        int m = (n > BLOC_CORREL) ? BLOC_CORREL : n;
+        const short *x = ech;
+        int k = m;
+
+        if (d->cfg.filtre) {
+            k = filtre_bloc(&d->filtre, ech, m, d->traite);
+            x = d->traite;
+        } else if (d->facteur > 1) {
+            k = decim_bloc(&d->decim, ech, m, d->traite);
+            x = d->traite;
+        }
+        if (d->cfg.porte) {
+            trames += porte_alimente(d, x, k);
+        } else {
+            trames += demod_traite(d, x, k);
+        }
+
+        d->n_entree += m;
+        ech += m;
+        n -= m;
+    }
+    return trames;
+}
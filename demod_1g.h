@@ -0,0 +1,138 @@
+/**********************************
+
+## Licence
+
+ Licence Creative Commons CC BY-NC-SA 
+
+## Auteurs et contributions
+
+- **Code original dec406_v7** : F4EHY (2020)
+- **Refactoring et support 2G** : Développement collaboratif (2025)
+- **Conformité T.018** : Implémentation complète BCH + MID database
+
+***********************************/
+
+// demod_1g.h - Reentrant 1G demodulator fed by sample blocks
+#ifndef DEMOD_1G_H
+#define DEMOD_1G_H
+
+#include <stdint.h>
+#include "trame406.h"
+
+// Threshold half-life while idle in continuous mode (seconds)
+#define DEMI_VIE_DEFAUT 5.0
+
+// Energy gate: level change (dB) over the last blocks that wakes the correlator
+#define PORTE_SEUIL_DB 1.5
+
+// Starting level of the correlator peaks max/min (--M4)
+#define NIVEAU_INITIAL 10e3
+
+// Threshold bank: at most this many coefficients share one correlator
+#define DEMOD_BANC_MAX 8
+
+// ===================================================
+// Configuration
+// ===================================================
+typedef struct {
+    int f_ech;              // Input sample rate (Hz)
+    int bauds;              // Bit rate (400 for 1G)
+    double coeff;           // Threshold coefficient
+    double banc[DEMOD_BANC_MAX - 1]; // More coefficients tried on the same bursts
+    double banc_niveau[DEMOD_BANC_MAX - 1]; // Their starting level, 0 for niveau
+    int n_banc;             // Number of them, 0 for coeff alone
+    double niveau;          // Starting level of max/min
+    int decimation;         // Decimation ratio (1 = off, 0 = auto)
+    int filtre;             // Built-in front end (DC blocker, FIR, band-pass)
+    double f_passe_haut;    // Front end high-pass corner (Hz)
+    double f_passe_bas;     // Front end low-pass corner (Hz)
+    int verbeux;            // Print sync and frame capture messages
+    int continu;            // Keep correlator and thresholds across frames
+    double demi_vie;        // Idle threshold half-life in continuous mode (s)
+    int porte;              // Skip the correlator while the level is steady
+    double porte_seuil;     // Level change that opens the gate (dB)
+} DemodConfig;
+
+// ===================================================
+// Demodulated frame
+// ===================================================
+typedef struct {
+    Trame406 bits;                  // 112 (short) or 144 (long) bits
+    uint8_t fiabilite[TRAME406_BITS_MAX]; // Per-bit reliability, 0 weakest, 128 typical
+    long long ech_sync;             // Input sample index where the preamble ended
+    double t_sync;                  // Same, sub-sample estimate from the sync matched filter
+    long long ech;                  // Input sample index at end of frame
+} TrameDemod;
+
+/**
+ * Frame callback, called from demod_alimente() for each frame captured
+ * @param trame Frame bits, only valid during the call
+ * @param utilisateur Pointer given to demod_cree()
+ */
+typedef void (*demod_trame_cb)(const TrameDemod *trame, void *utilisateur);
+
+typedef struct Demod1G Demod1G;
+
+// ===================================================
+// Functions
+// ===================================================
+
+/**
+ * Fill a configuration with the decoder defaults
+ * @param cfg Configuration to fill
+ * @param f_ech Input sample rate (Hz)
+ */
+void demod_config_defaut(DemodConfig *cfg, int f_ech);
+
+/**
+ * Create a demodulator; each one owns its whole state
+ * @param cfg Configuration, copied
+ * @param cb Frame callback
+ * @param utilisateur Pointer passed back to cb
+ * @return New demodulator, NULL if the rate is too low or on allocation error
+ */
+Demod1G *demod_cree(const DemodConfig *cfg, demod_trame_cb cb, void *utilisateur);
+
+/**
+ * Free a demodulator
+ * @param d Demodulator from demod_cree(), may be NULL
+ */
+void demod_detruit(Demod1G *d);
+
+/**
+ * Push input samples; frames found are passed to the callback
+ * @param d Demodulator
+ * @param ech 16-bit samples at the input rate
+ * @param n Number of samples
+ * @return Number of frames captured in this block
+ */
+int demod_alimente(Demod1G *d, const short *ech, int n);
+
+/**
+ * Drop the current sync search and restart from fresh thresholds
+ * @param d Demodulator
+ */
+void demod_reinit(Demod1G *d);
+
+/**
+ * Hand over frames the threshold bank still holds, at the end of a stream
+ * @param d Demodulator
+ * @return Number of frames passed to the callback
+ */
+int demod_vide(Demod1G *d);
+
+/**
+ * Share of the samples that went through the correlator
+ * @param d Demodulator
+ * @return 1.0 without the energy gate, less when it skipped quiet spans
+ */
+double demod_charge(const Demod1G *d);
+
+/**
+ * Input samples consumed since creation
+ * @param d Demodulator
+ * @return Sample count at the input rate
+ */
+long long demod_position(const Demod1G *d);
+
+#endif // DEMOD_1G_H
@@ -0,0 +1,659 @@
+/**********************************
+
+## Licence
+
+ Licence Creative Commons CC BY-NC-SA 
+
+## Auteurs et contributions
+
+- **Code original dec406_v7** : F4EHY (2020)
+- **Refactoring et support 2G** : Développement collaboratif (2025)
+- **Conformité T.018** : Implémentation complète BCH + MID database
+
+***********************************/
+
+// demod_2g.c - Second-generation (T.018) OQPSK-DSSS receiver on raw IQ
+//
+// Raw IQ is channel-filtered, decimated and resampled (cubic) to exactly
+// 4 samples per chip. Each chip is integrated over its 4 samples.
+//
+// Acquisition works on hard chips: for every carrier bin the chip signs
+// are packed 32 per word, one stream per sample phase, and every start
+// sample is tried against the first SGB_ACQ_CHIPS chips of the preamble
+// with the XOR/popcount correlator. Segments are summed non-coherently,
+// so the bins only need to be closer than the segment bandwidth.
+//
+// Once a start is found its preamble is buffered and the carrier refined
+// on it; a start whose preamble does not add up coherently is dropped.
+// The rest of the burst is then demodulated soft, one bit period at a
+// time, with a decision-directed phase loop and an early/late chip timing
+// loop. The I component carries the odd message bits, Q (half a chip
+// late) the even ones.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "demod_2g.h"
+#include "acq_2g.h"
+#include "demod_kernels.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Front end: rate aimed at before resampling, channel half-width (Hz)
+#define SGB_F_FILTRE 192000
+#define SGB_BANDE 42000.0
+
+// Acquisition: preamble chips correlated, in 32-chip segments
+#define SGB_ACQ_CHIPS 512
+#define SGB_ACQ_SEGMENTS (SGB_ACQ_CHIPS / 32)
+#define SGB_ACQ_PREMIERS 4          // Segments tried before the rest
+#define SGB_ACQ_PAS 800.0           // Carrier bin spacing (Hz)
+#define SGB_ACQ_CANAUX 9
+#define SGB_ACQ_PRESEUIL 1.6        // On the first segments, noise mean 1
+#define SGB_ACQ_SEUIL 2.8           // On all segments, noise mean 1
+#define SGB_ACQ_PIC 8               // Samples searched past the first hit
+
+// Starts from the FFT search waiting while a burst is checked
+#define SGB_FILE 8
+
+// Packed chip streams per carrier bin, phase and part: 8192 chips, enough
+// to search again the starts skipped while a preamble was checked
+#define SGB_MOTS 128
+
+// Sample ring at SGB_F_ECH, holds a whole burst plus the search delay
+#define SGB_ANNEAU (1 << 18)
+
+// Burst samples past the start still needed by the tracking loops
+#define SGB_MARGE 200
+
+// Tracking gains, per bit period
+#define SGB_KP_PHASE 0.3
+#define SGB_KI_PHASE 0.03
+#define SGB_K_RYTHME 0.5
+#define SGB_KI_RYTHME 0.05
+
+// False starts: preamble coherence (noise about 1, clean burst 25) and
+// Eb/N0 over the message
+#define SGB_PREAMBULE_MIN 12.0
+#define SGB_EB_N0_MIN 4.0
+
+// T.018 PRN generator G(x) = x^23 + x^18 + 1, normal mode initial states
+#define SGB_PRN_I_INIT 0x000001
+#define SGB_PRN_Q_INIT 0x1AC1FC
+
+struct Demod2G {
+    FormatIQ format;
+    int f_iq;
+    trame2g_cb cb;
+    void *utilisateur;
+    long long n_entree;         // Input samples consumed
+    // Front end
+    FiltreIQ filtre;
+    float *re;                  // Conversion and filter buffer
+    float *im;
+    double pas;                 // Filtered samples per output sample
+    double t;                   // Next output, in filtered samples
+    long long j;                // Filtered samples received
+    float hist_re[4];           // Last 4 filtered samples
+    float hist_im[4];
+    // Spreading codes, +1/-1 per chip, and packed acquisition segments
+    signed char *prn_i;
+    signed char *prn_q;
+    uint32_t prn_mots[4 * SGB_ACQ_SEGMENTS];
+    // Samples at SGB_F_ECH
+    float *anneau_re;
+    float *anneau_im;
+    long long n;
+    // Acquisition
+    double rot_re[SGB_ACQ_CANAUX];  // Derotation phasor per bin
+    double rot_im[SGB_ACQ_CANAUX];
+    double pas_re[SGB_ACQ_CANAUX];
+    double pas_im[SGB_ACQ_CANAUX];
+    uint64_t *puces;            // [bin][phase][re/im][SGB_MOTS]
+    double meilleur;            // Best metric of the current hit, 0 if none
+    long long debut;            // Its start sample
+    double f_acq;               // Its carrier offset (Hz)
+    long long fin_pic;          // Last start searched for the hit
+    long long reprise;          // First start searched again after a burst
+    int attente;                // 1: preamble buffered until sample fin,
+    long long fin;              // 2: whole burst buffered until fin
+    // Carrier found on the preamble: rad/sample, phase at the start
+    double w;
+    double theta;
+    // FFT search, replacing the packed chips when set
+    Acq2G *fft;
+    DetectionSGB file[SGB_FILE];
+    int n_file;
+};
+
+// ===================================================
+// Spreading codes
+// ===================================================
+static void prn_genere(uint32_t etat, signed char *puce, int n) {
+    int k;
+
+    for (k = 0; k < n; k++) {
+        uint32_t fb = (etat ^ (etat >> 18)) & 1;
+        puce[k] = (etat & 1) ? -1 : 1;
+        etat = (etat >> 1) | (fb << 22);
+    }
+}
+
+// Word w holds chips 32*w to 32*w+31, bit set for -1
+static void prn_packe(const signed char *puce, uint32_t *mots, int n_mots) {
+    int w, k;
+
+    for (w = 0; w < n_mots; w++) {
+        mots[w] = 0;
+        for (k = 0; k < 32; k++) {
+            if (puce[32 * w + k] < 0) mots[w] |= 1u << k;
+        }
+    }
+}
+
+// ===================================================
+// Creation
+// ===================================================
+Demod2G *demod2g_cree(FormatIQ format, int f_iq, trame2g_cb cb, void *utilisateur) {
+    Demod2G *d;
+    uint32_t seg_i[SGB_ACQ_SEGMENTS], seg_q[SGB_ACQ_SEGMENTS];
+    int facteur, b, s;
+
+    if (format == IQ_AUCUN || f_iq < SGB_F_ECH) {
+        fprintf(stderr, "2G receiver needs at least %d Hz of IQ\n", SGB_F_ECH);
+        return NULL;
+    }
+    d = calloc(1, sizeof(Demod2G));
+    if (!d) return NULL;
+    d->format = format;
+    d->f_iq = f_iq;
+    d->cb = cb;
+    d->utilisateur = utilisateur;
+
+    facteur = f_iq / SGB_F_FILTRE;
+    if (facteur < 1) facteur = 1;
+    d->pas = (double)f_iq / facteur / SGB_F_ECH;
+    d->t = 1.0;
+
+    d->re = malloc(IQ_BLOC * sizeof(float));
+    d->im = malloc(IQ_BLOC * sizeof(float));
+    d->prn_i = malloc(SGB_CHIPS);
+    d->prn_q = malloc(SGB_CHIPS);
+    d->anneau_re = calloc(SGB_ANNEAU, sizeof(float));
+    d->anneau_im = calloc(SGB_ANNEAU, sizeof(float));
+    d->puces = calloc(SGB_ACQ_CANAUX * 4 * 2 * SGB_MOTS, sizeof(uint64_t));
+    if (!d->re || !d->im || !d->prn_i || !d->prn_q || !d->anneau_re ||
+        !d->anneau_im || !d->puces ||
+        filtre_iq_init(&d->filtre, f_iq, facteur, SGB_BANDE) != 0) {
+        demod2g_detruit(d);
+        return NULL;
+    }
+
+    prn_genere(SGB_PRN_I_INIT, d->prn_i, SGB_CHIPS);
+    prn_genere(SGB_PRN_Q_INIT, d->prn_q, SGB_CHIPS);
+    prn_packe(d->prn_i, seg_i, SGB_ACQ_SEGMENTS);
+    prn_packe(d->prn_q, seg_q, SGB_ACQ_SEGMENTS);
+    // Same layout as the received words: I re, I im, Q re, Q im per segment
+    for (s = 0; s < SGB_ACQ_SEGMENTS; s++) {
+        d->prn_mots[4 * s] = seg_i[s];
+        d->prn_mots[4 * s + 1] = seg_i[s];
+        d->prn_mots[4 * s + 2] = seg_q[s];
+        d->prn_mots[4 * s + 3] = seg_q[s];
+    }
+
+    for (b = 0; b < SGB_ACQ_CANAUX; b++) {
+        double f = (b - SGB_ACQ_CANAUX / 2) * SGB_ACQ_PAS;
+        double w = -2.0 * M_PI * f / SGB_F_ECH;
+        d->rot_re[b] = 1.0;
+        d->rot_im[b] = 0.0;
+        d->pas_re[b] = cos(w);
+        d->pas_im[b] = sin(w);
+    }
+    noyaux_init();
+    return d;
+}
+
+int demod2g_fft(Demod2G *d, int n_fils) {
+    acq2g_detruit(d->fft);
+    d->fft = acq2g_cree(d->prn_i, d->prn_q, SGB_DECALAGE_MAX, n_fils);
+    return d->fft == NULL;
+}
+
+void demod2g_detruit(Demod2G *d) {
+    if (!d) return;
+    acq2g_detruit(d->fft);
+    filtre_iq_libere(&d->filtre);
+    free(d->re);
+    free(d->im);
+    free(d->prn_i);
+    free(d->prn_q);
+    free(d->anneau_re);
+    free(d->anneau_im);
+    free(d->puces);
+    free(d);
+}
+
+void demod2g_affiche(const Demod2G *d) {
+    printf("2G receiver: %d Hz IQ, decimation %d (%d taps), resampled to %d Hz\n",
+           d->f_iq, d->filtre.facteur, d->filtre.ntaps, SGB_F_ECH);
+    if (d->fft) {
+        acq2g_affiche(d->fft);
+    } else {
+        printf("Acquisition: %d preamble chips, %d carrier bins %.0f Hz apart, kernels %s\n",
+               SGB_ACQ_CHIPS, SGB_ACQ_CANAUX, SGB_ACQ_PAS, noyaux.nom);
+    }
+}
+
+long long demod2g_position(const Demod2G *d) {
+    return d->n_entree;
+}
+
+// Input sample matching a sample at SGB_F_ECH
+static long long ech_entree(const Demod2G *d, double n) {
+    double j = n * d->pas + 1.0;
+    return (long long)floor((j + 1.0) * d->filtre.facteur - 1.0 - (d->filtre.ntaps - 1) / 2.0 + 0.5);
+}
+
+// ===================================================
+// Acquisition
+// ===================================================
+static inline uint64_t *flux(Demod2G *d, int canal, int phase, int partie) {
+    return d->puces + ((canal * 4 + phase) * 2 + partie) * SGB_MOTS;
+}
+
+// 32 chips from chip c on
+static inline uint32_t extrait(const uint64_t *f, long long c) {
+    unsigned i = (unsigned)(c >> 6) & (SGB_MOTS - 1);
+    unsigned dec = (unsigned)(c & 63);
+    uint64_t v = f[i] >> dec;
+    if (dec > 32) v |= f[(i + 1) & (SGB_MOTS - 1)] << (64 - dec);
+    return (uint32_t)v;
+}
+
+// Non-coherent metric of a start on one bin, about 1 on noise
+static double acq_metrique(Demod2G *d, int canal, long long s0) {
+    uint32_t mots[4 * SGB_ACQ_SEGMENTS];
+    int c[4 * SGB_ACQ_SEGMENTS];
+    const uint64_t *i_re, *i_im, *q_re, *q_im;
+    long long ci = (s0 + 3) >> 2, cq = (s0 + 5) >> 2;
+    int pi = (int)((s0 + 3) & 3), pq = (int)((s0 + 5) & 3);
+    double somme = 0.0;
+    int s, k;
+
+    // I chip k ends at sample s0+4k+3, Q chip k half a chip later
+    i_re = flux(d, canal, pi, 0);
+    i_im = flux(d, canal, pi, 1);
+    q_re = flux(d, canal, pq, 0);
+    q_im = flux(d, canal, pq, 1);
+    for (s = 0; s < SGB_ACQ_SEGMENTS; s++) {
+        if (s == SGB_ACQ_PREMIERS) {
+            // Carrier at angle a: I gives cos a on re, sin a on im; Q (j*q)
+            // gives -sin a on re, cos a on im
+            noyaux.concordances(mots, d->prn_mots, 4 * s, c);
+            for (k = 0; k < s; k++) {
+                double a = c[4 * k] + c[4 * k + 3], b = c[4 * k + 1] - c[4 * k + 2];
+                somme += a * a + b * b;
+            }
+            if (somme < SGB_ACQ_PRESEUIL * 128.0 * s) return 0.0;
+        }
+        mots[4 * s] = extrait(i_re, ci + 32 * s);
+        mots[4 * s + 1] = extrait(i_im, ci + 32 * s);
+        mots[4 * s + 2] = extrait(q_re, cq + 32 * s);
+        mots[4 * s + 3] = extrait(q_im, cq + 32 * s);
+    }
+    noyaux.concordances(mots + 4 * SGB_ACQ_PREMIERS, d->prn_mots + 4 * SGB_ACQ_PREMIERS,
+                        4 * (SGB_ACQ_SEGMENTS - SGB_ACQ_PREMIERS), c + 4 * SGB_ACQ_PREMIERS);
+    for (k = SGB_ACQ_PREMIERS; k < SGB_ACQ_SEGMENTS; k++) {
+        double a = c[4 * k] + c[4 * k + 3], b = c[4 * k + 1] - c[4 * k + 2];
+        somme += a * a + b * b;
+    }
+    return somme / (128.0 * SGB_ACQ_SEGMENTS);
+}
+
+// Pack the chip signs ending at the last sample, one bit per bin
+static void acq_empile(Demod2G *d) {
+    long long n = d->n - 1, c;
+    int b, phase, k;
+    float br = 0.0f, bi = 0.0f;
+    uint64_t bit;
+
+    for (k = 0; k < SGB_ECH_CHIP; k++) {
+        br += d->anneau_re[(n - k) & (SGB_ANNEAU - 1)];
+        bi += d->anneau_im[(n - k) & (SGB_ANNEAU - 1)];
+    }
+    c = n >> 2;
+    phase = (int)(n & 3);
+    bit = 1ull << (c & 63);
+    for (b = 0; b < SGB_ACQ_CANAUX; b++) {
+        double yr = br * d->rot_re[b] - bi * d->rot_im[b];
+        double yi = br * d->rot_im[b] + bi * d->rot_re[b];
+        double r = d->rot_re[b] * d->pas_re[b] - d->rot_im[b] * d->pas_im[b];
+        uint64_t *f_re = flux(d, b, phase, 0), *f_im = flux(d, b, phase, 1);
+        unsigned w = (unsigned)(c >> 6) & (SGB_MOTS - 1);
+
+        d->rot_im[b] = d->rot_re[b] * d->pas_im[b] + d->rot_im[b] * d->pas_re[b];
+        d->rot_re[b] = r;
+        if ((c & 63) == 0) {
+            f_re[w] = 0;
+            f_im[w] = 0;
+        }
+        if (yr < 0.0) f_re[w] |= bit;
+        if (yi < 0.0) f_im[w] |= bit;
+    }
+    if ((n & 1023) == 0) {
+        for (b = 0; b < SGB_ACQ_CANAUX; b++) {
+            double m = sqrt(d->rot_re[b] * d->rot_re[b] + d->rot_im[b] * d->rot_im[b]);
+            d->rot_re[b] /= m;
+            d->rot_im[b] /= m;
+        }
+    }
+}
+
+// Try start s0 on every bin; past the best hit, buffer its preamble
+static void acq_essaie(Demod2G *d, long long s0) {
+    int b;
+
+    for (b = 0; b < SGB_ACQ_CANAUX; b++) {
+        double m = acq_metrique(d, b, s0);
+        if (m > SGB_ACQ_SEUIL && m > d->meilleur) {
+            if (d->meilleur == 0.0) d->fin_pic = s0 + SGB_ACQ_PIC;
+            d->meilleur = m;
+            d->debut = s0;
+            d->f_acq = (b - SGB_ACQ_CANAUX / 2) * SGB_ACQ_PAS;
+        }
+    }
+    if (d->meilleur > 0.0 && s0 >= d->fin_pic) {
+        d->attente = 1;
+        d->fin = d->debut + (long long)SGB_ECH_CHIP * SGB_BITS_PREAMBULE * SGB_CHIPS_BIT + SGB_MARGE;
+        d->meilleur = 0.0;
+    }
+}
+
+// Last start whose acquisition chips have all arrived
+static inline long long acq_dernier(const Demod2G *d) {
+    return d->n - 1 - SGB_ECH_CHIP * (SGB_ACQ_CHIPS - 1) - 5;
+}
+
+// ===================================================
+// Burst demodulation
+// ===================================================
+typedef struct {
+    double re, im;
+} Complexe;
+
+// Chip integral of 4 samples from sample a, derotated by angle phi
+static inline Complexe puce(const Demod2G *d, long long a, double phi) {
+    float sr = 0.0f, si = 0.0f;
+    double c = cos(phi), s = sin(phi);
+    Complexe z;
+    int k;
+
+    for (k = 0; k < SGB_ECH_CHIP; k++) {
+        sr += d->anneau_re[(a + k) & (SGB_ANNEAU - 1)];
+        si += d->anneau_im[(a + k) & (SGB_ANNEAU - 1)];
+    }
+    z.re = sr * c + si * s;
+    z.im = si * c - sr * s;
+    return z;
+}
+
+// Preamble despread in blocks of l chips: I + (-j)Q, carrier w rad/sample
+static void preambule_blocs(const Demod2G *d, long long s0, double w, int l, Complexe *bloc) {
+    int k, n = SGB_BITS_PREAMBULE * SGB_CHIPS_BIT / l;
+
+    for (k = 0; k < n; k++) {
+        Complexe acc = { 0.0, 0.0 };
+        int c;
+        for (c = k * l; c < (k + 1) * l; c++) {
+            long long a = s0 + (long long)SGB_ECH_CHIP * c;
+            Complexe zi = puce(d, a, w * (a + 1.5 - s0));
+            Complexe zq = puce(d, a + 2, w * (a + 3.5 - s0));
+            acc.re += d->prn_i[c] * zi.re + d->prn_q[c] * zq.im;
+            acc.im += d->prn_i[c] * zi.im - d->prn_q[c] * zq.re;
+        }
+        bloc[k] = acc;
+    }
+}
+
+// Frequency step between consecutive blocks of l chips (rad/sample)
+static double preambule_frequence(const Complexe *bloc, int n, int l) {
+    double re = 0.0, im = 0.0;
+    int k;
+
+    for (k = 1; k < n; k++) {
+        re += bloc[k].re * bloc[k - 1].re + bloc[k].im * bloc[k - 1].im;
+        im += bloc[k].im * bloc[k - 1].re - bloc[k].re * bloc[k - 1].im;
+    }
+    return atan2(im, re) / (l * SGB_ECH_CHIP);
+}
+
+// Carrier from the preamble: bin centre, then 32-chip blocks (+/-600 Hz),
+// then 256-chip blocks (+/-75 Hz); phase from the whole preamble
+// Return the coherence |sum|^2 / sum |.|^2 of the 256-chip blocks
+static double preambule_porteuse(Demod2G *d) {
+    Complexe bloc[SGB_BITS_PREAMBULE * SGB_CHIPS_BIT / 32];
+    Complexe acc = { 0.0, 0.0 };
+    double energie = 0.0;
+    long long s0 = d->debut;
+    int k;
+
+    d->w = 2.0 * M_PI * d->f_acq / SGB_F_ECH;
+    preambule_blocs(d, s0, d->w, 32, bloc);
+    d->w += preambule_frequence(bloc, SGB_BITS_PREAMBULE * SGB_CHIPS_BIT / 32, 32);
+    preambule_blocs(d, s0, d->w, SGB_CHIPS_BIT, bloc);
+    d->w += preambule_frequence(bloc, SGB_BITS_PREAMBULE, SGB_CHIPS_BIT);
+    preambule_blocs(d, s0, d->w, SGB_CHIPS_BIT, bloc);
+    for (k = 0; k < SGB_BITS_PREAMBULE; k++) {
+        acc.re += bloc[k].re;
+        acc.im += bloc[k].im;
+        energie += bloc[k].re * bloc[k].re + bloc[k].im * bloc[k].im;
+    }
+    d->theta = atan2(acc.im, acc.re);
+    return (energie > 0.0) ? (acc.re * acc.re + acc.im * acc.im) / energie : 0.0;
+}
+
+static int demodule_salve(Demod2G *d) {
+    double w = d->w, theta = d->theta, tau, spc, somme = 0.0, carres = 0.0;
+    long long s0 = d->debut;
+    Trame2G trame;
+    double amplitude[SGB_BITS];
+    int k, n_mesures = 0;
+
+    // One bit period at a time: prompt, early and late (half a chip each
+    // side) despread on I and Q; theta is the phase at sample tau
+    tau = (double)s0;
+    spc = SGB_ECH_CHIP;
+    trame406_efface(&trame.bits, SGB_BITS);
+    for (k = 0; k < SGB_BITS_PREAMBULE + SGB_BITS / 2; k++) {
+        Complexe pi = { 0, 0 }, pq = { 0, 0 }, ei = { 0, 0 }, eq = { 0, 0 };
+        Complexe li = { 0, 0 }, lq = { 0, 0 }, v, e, l;
+        double si, sq, erreur, delta, me, ml;
+        int c;
+
+        for (c = 0; c < SGB_CHIPS_BIT; c++) {
+            int g = k * SGB_CHIPS_BIT + c;
+            double x = tau + c * spc;
+            long long a = (long long)floor(x + 0.5);
+            double phi = theta + w * (a + 1.5 - tau);
+            Complexe z;
+
+            z = puce(d, a, phi);
+            pi.re += d->prn_i[g] * z.re;
+            pi.im += d->prn_i[g] * z.im;
+            z = puce(d, a - 2, phi - 2.0 * w);
+            ei.re += d->prn_i[g] * z.re;
+            ei.im += d->prn_i[g] * z.im;
+            z = puce(d, a + 2, phi + 2.0 * w);
+            li.re += d->prn_i[g] * z.re;
+            li.im += d->prn_i[g] * z.im;
+            // Q chips: the early one is the I prompt position
+            z = puce(d, a + 2, phi + 2.0 * w);
+            pq.re += d->prn_q[g] * z.re;
+            pq.im += d->prn_q[g] * z.im;
+            z = puce(d, a, phi);
+            eq.re += d->prn_q[g] * z.re;
+            eq.im += d->prn_q[g] * z.im;
+            z = puce(d, a + 4, phi + 4.0 * w);
+            lq.re += d->prn_q[g] * z.re;
+            lq.im += d->prn_q[g] * z.im;
+        }
+
+        // Preamble bits are 0 (+1); message bits decided on I re, Q im
+        if (k < SGB_BITS_PREAMBULE) {
+            si = 1.0;
+            sq = 1.0;
+        } else {
+            int b = 2 * (k - SGB_BITS_PREAMBULE);
+            si = (pi.re >= 0.0) ? 1.0 : -1.0;
+            sq = (pq.im >= 0.0) ? 1.0 : -1.0;
+            trame406_met(&trame.bits, b, si < 0.0);
+            trame406_met(&trame.bits, b + 1, sq < 0.0);
+            amplitude[b] = si * pi.re;
+            amplitude[b + 1] = sq * pq.im;
+            somme += si * pi.re + sq * pq.im;
+            carres += pi.re * pi.re + pq.im * pq.im;
+            n_mesures += 2;
+        }
+        v.re = si * pi.re + sq * pq.im;
+        v.im = si * pi.im - sq * pq.re;
+        e.re = si * ei.re + sq * eq.im;
+        e.im = si * ei.im - sq * eq.re;
+        l.re = si * li.re + sq * lq.im;
+        l.im = si * li.im - sq * lq.re;
+
+        // Phase loop
+        erreur = atan2(v.im, v.re);
+        theta += w * SGB_CHIPS_BIT * spc + SGB_KP_PHASE * erreur;
+        w += SGB_KI_PHASE * erreur / (SGB_CHIPS_BIT * spc);
+
+        // Chip timing: early - late is 2 * delta chips on a triangle
+        me = sqrt(e.re * e.re + e.im * e.im);
+        ml = sqrt(l.re * l.re + l.im * l.im);
+        delta = (me + ml > 0.0) ? 0.5 * (ml - me) / (me + ml) : 0.0;
+        tau += SGB_CHIPS_BIT * spc + SGB_K_RYTHME * delta * SGB_ECH_CHIP;
+        spc += SGB_KI_RYTHME * delta * SGB_ECH_CHIP / SGB_CHIPS_BIT;
+    }
+
+    // Eb/N0 from the mean and spread of the despread message bits
+    {
+        double moyenne = somme / n_mesures;
+        double variance = carres / n_mesures - moyenne * moyenne;
+        trame.eb_n0 = (variance > 0.0) ? 10.0 * log10(moyenne * moyenne / (2.0 * variance)) : 99.0;
+
+        // Soft decisions: despread amplitude, 128 at the mean
+        memset(trame.fiabilite, 0, sizeof(trame.fiabilite));
+        for (k = 0; k < SGB_BITS; k++) {
+            double v = (moyenne > 0.0) ? 128.0 * amplitude[k] / moyenne : 0.0;
+            trame.fiabilite[k] = (v <= 0.0) ? 0 : (v >= 255.0) ? 255 : (uint8_t)v;
+        }
+    }
+    if (trame.eb_n0 < SGB_EB_N0_MIN) return 0;
+    trame.ech = ech_entree(d, (double)s0);
+    trame.decalage = w * SGB_F_ECH / (2.0 * M_PI);
+    trame.derive = (SGB_ECH_CHIP / spc - 1.0) * 1e6;
+    d->cb(&trame, d->utilisateur);
+    return 1;
+}
+
+// ===================================================
+// Stream processing
+// ===================================================
+// Start the oldest queued FFT hit past the last burst
+static void file_prend(Demod2G *d) {
+    while (d->n_file > 0 && !d->attente) {
+        DetectionSGB det = d->file[0];
+        d->n_file--;
+        memmove(d->file, d->file + 1, d->n_file * sizeof(DetectionSGB));
+        if (det.debut < d->reprise) continue;
+        d->debut = det.debut;
+        d->f_acq = det.decalage;
+        d->attente = 1;
+        d->fin = d->debut + (long long)SGB_ECH_CHIP * SGB_BITS_PREAMBULE * SGB_CHIPS_BIT + SGB_MARGE;
+    }
+}
+
+static int pousse(Demod2G *d, float re, float im) {
+    long long s0;
+    int n = 0;
+
+    d->anneau_re[d->n & (SGB_ANNEAU - 1)] = re;
+    d->anneau_im[d->n & (SGB_ANNEAU - 1)] = im;
+    d->n++;
+    if (d->fft) {
+        DetectionSGB det;
+        if (acq2g_pousse(d->fft, re, im, &det) && d->n_file < SGB_FILE) {
+            d->file[d->n_file++] = det;
+        }
+        file_prend(d);
+        s0 = 0;
+    } else {
+        acq_empile(d);
+        s0 = acq_dernier(d);
+        if (!d->attente && s0 >= d->reprise) acq_essaie(d, s0);
+    }
+    if (d->attente == 1 && d->n >= d->fin) {
+        // A false start is dropped after its preamble; the starts skipped
+        // meanwhile are searched again (packed chips) or were queued (FFT)
+        if (preambule_porteuse(d) >= SGB_PREAMBULE_MIN) {
+            d->attente = 2;
+            d->fin = d->debut + (long long)SGB_ECH_CHIP * SGB_CHIPS + SGB_MARGE;
+        } else {
+            long long s;
+            d->attente = 0;
+            d->reprise = d->debut + 1;
+            if (d->fft) {
+                file_prend(d);
+            } else {
+                for (s = d->reprise; s <= s0 && !d->attente; s++) acq_essaie(d, s);
+            }
+        }
+    } else if (d->attente == 2 && d->n >= d->fin) {
+        n = demodule_salve(d);
+        d->attente = 0;
+        d->reprise = n ? d->fin - SGB_MARGE : d->debut + 1;
+        if (d->fft) file_prend(d);
+    }
+    return n;
+}
+
+int demod2g_alimente(Demod2G *d, const void *brut, int n) {
+    const unsigned char *p = brut;
+    int trames = 0;
+
+    while (n > 0) {
+        int l = (n < IQ_BLOC) ? n : IQ_BLOC;
+        int m, i;
+
+        iq_convertit(d->format, p, l, d->re, d->im);
+        m = filtre_iq_bloc(&d->filtre, d->re, d->im, l);
+        for (i = 0; i < m; i++) {
+            d->hist_re[0] = d->hist_re[1];
+            d->hist_re[1] = d->hist_re[2];
+            d->hist_re[2] = d->hist_re[3];
+            d->hist_re[3] = d->re[i];
+            d->hist_im[0] = d->hist_im[1];
+            d->hist_im[1] = d->hist_im[2];
+            d->hist_im[2] = d->hist_im[3];
+            d->hist_im[3] = d->im[i];
+            // Cubic Lagrange between hist[1] (filtered sample j-2) and hist[2]
+            while (d->t < d->j - 1) {
+                double u = d->t - (d->j - 2);
+                double c0 = -u * (u - 1.0) * (u - 2.0) / 6.0;
+                double c1 = (u + 1.0) * (u - 1.0) * (u - 2.0) / 2.0;
+                double c2 = -(u + 1.0) * u * (u - 2.0) / 2.0;
+                double c3 = (u + 1.0) * u * (u - 1.0) / 6.0;
+                trames += pousse(d,
+                    (float)(c0 * d->hist_re[0] + c1 * d->hist_re[1] + c2 * d->hist_re[2] + c3 * d->hist_re[3]),
+                    (float)(c0 * d->hist_im[0] + c1 * d->hist_im[1] + c2 * d->hist_im[2] + c3 * d->hist_im[3]));
+                d->t += d->pas;
+            }
+            d->j++;
+        }
+        p += (size_t)l * iq_octets(d->format);
+        d->n_entree += l;
+        n -= l;
+    }
+    return trames;
+}
@@ -0,0 +1,106 @@
+/**********************************
+
+## Licence
+
+ Licence Creative Commons CC BY-NC-SA 
+
+## Auteurs et contributions
+
+- **Code original dec406_v7** : F4EHY (2020)
+- **Refactoring et support 2G** : Développement collaboratif (2025)
+- **Conformité T.018** : Implémentation complète BCH + MID database
+
+***********************************/
+
+// demod_2g.h - Second-generation (T.018) OQPSK-DSSS receiver on raw IQ
+#ifndef DEMOD_2G_H
+#define DEMOD_2G_H
+
+#include <stdint.h>
+#include "iq_demod.h"
+#include "trame406.h"
+
+// T.018 burst: 38400 chips/s on I and Q for 1 s, 256 chips per bit on
+// each component, 25 preamble bits of 0 then 125 message bits per component
+#define SGB_DEBIT_CHIPS 38400
+#define SGB_CHIPS 38400
+#define SGB_CHIPS_BIT 256
+#define SGB_BITS_PREAMBULE 25
+#define SGB_BITS 250
+
+// Receiver rate: 4 samples per chip
+#define SGB_ECH_CHIP 4
+#define SGB_F_ECH (SGB_ECH_CHIP * SGB_DEBIT_CHIPS)
+
+// Carrier offsets searched on each side of the tuner frequency (Hz)
+#define SGB_DECALAGE_MAX 3600.0
+
+// ===================================================
+// Received burst
+// ===================================================
+typedef struct {
+    Trame406 bits;              // Message bits 1 to 250
+    uint8_t fiabilite[TRAME406_BITS_MAX]; // Per-bit reliability, 0 weakest, 128 typical
+    long long ech;              // Input sample of the burst start
+    double decalage;            // Carrier offset (Hz)
+    double derive;              // Chip clock error (ppm)
+    double eb_n0;               // Estimated Eb/N0 over the message (dB)
+} Trame2G;
+
+/**
+ * Burst callback, called from demod2g_alimente() for each burst received
+ * @param trame Burst, only valid during the call
+ * @param utilisateur Pointer given to demod2g_cree()
+ */
+typedef void (*trame2g_cb)(const Trame2G *trame, void *utilisateur);
+
+typedef struct Demod2G Demod2G;
+
+/**
+ * Create a receiver for T.018 bursts in normal mode
+ * @param format Raw sample format
+ * @param f_iq Input sample rate (Hz), at least SGB_F_ECH
+ * @param cb Burst callback
+ * @param utilisateur Pointer passed back to cb
+ * @return New receiver, NULL if the rate is too low or on allocation error
+ */
+Demod2G *demod2g_cree(FormatIQ format, int f_iq, trame2g_cb cb, void *utilisateur);
+
+/**
+ * Search for bursts by FFT over all code phases instead of the packed
+ * chip correlators: more sensitive, heavier, carrier bins on n_fils threads
+ * @param d Receiver
+ * @param n_fils Worker threads, 0 for one per CPU
+ * @return 0 on success, 1 on allocation error
+ */
+int demod2g_fft(Demod2G *d, int n_fils);
+
+/**
+ * Free a receiver
+ * @param d Receiver from demod2g_cree(), may be NULL
+ */
+void demod2g_detruit(Demod2G *d);
+
+/**
+ * Push raw IQ samples; bursts are reported about one burst length later
+ * @param d Receiver
+ * @param brut Raw samples in the configured format
+ * @param n Number of complex samples
+ * @return Number of bursts reported
+ */
+int demod2g_alimente(Demod2G *d, const void *brut, int n);
+
+/**
+ * Describe the receiver set-up on stdout
+ * @param d Receiver
+ */
+void demod2g_affiche(const Demod2G *d);
+
+/**
+ * Input samples consumed since creation
+ * @param d Receiver
+ * @return Sample count at the input rate
+ */
+long long demod2g_position(const Demod2G *d);
+
+#endif // DEMOD_2G_H
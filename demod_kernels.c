@@ -0,0 +1,476 @@
+/**********************************
+
+## Licence
+
+ Licence Creative Commons CC BY-NC-SA 
+
+## Auteurs et contributions
+
+- **Code original dec406_v7** : F4EHY (2020)
+- **Refactoring et support 2G** : Développement collaboratif (2025)
+- **Conformité T.018** : Implémentation complète BCH + MID database
+
+***********************************/
+
+// demod_kernels.c - Vectorized inner loops of the 1G demodulator and IQ front end
+//
+// All correlator values are integers below 2^53, so the SIMD paths give
+// bit-identical results to the scalar fallback. The integer correlator of
+// the DEMOD_ENTIER build has portable kernels only, on planar 32-bit lanes
+// in fixed-length inner loops that the compiler vectorizes (NEON on ARM).
+// The IQ kernels work in float; their SIMD paths only differ from the
+// scalar ones by rounding. The packed chip correlation is exact on every
+// path.
+#include <math.h>
+#include "demod_kernels.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define NOYAUX_X86 1
+#endif
+
+// ===================================================
+// Portable scalar kernels
+// ===================================================
+#ifdef DEMOD_ENTIER
+static void convertit_scalaire(const short *x, int n, int32_t *y) {
+    for (int i = 0; i < n; i++) y[i] = x[i];
+}
+
+static void increments_scalaire(const int32_t *restrict h, int Nb, int n,
+                                int32_t *restrict d, int32_t *restrict e) {
+    for (int t = 0; t < n; t++) {
+        int32_t delta = h[t + 2 * Nb] - h[t];
+        d[t] = h[t + Nb] * delta;
+        e[t] = delta;
+    }
+}
+
+// Arithmetic shift: negative values round down like positive ones
+static void correlation_scalaire(const int64_t *restrict P, const int64_t *restrict S, int n,
+                                 int q, int decalage, int32_t *restrict Y1) {
+    for (int i = 0; i < n; i++) Y1[i] = (int32_t)((q * P[i] - S[i] * S[i]) >> decalage);
+}
+
+// Eight lanes tested together before looking for the first one out
+static int cherche_scalaire(const int32_t *Y1, int n, int32_t haut, int32_t bas) {
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        int hors = 0;
+        for (int j = 0; j < 8; j++) hors |= (Y1[i + j] > haut) | (Y1[i + j] < bas);
+        if (hors) break;
+    }
+    for (; i < n; i++) {
+        if (Y1[i] > haut || Y1[i] < bas) return i;
+    }
+    return n;
+}
+#else
+static void convertit_scalaire(const short *x, int n, double *y) {
+    for (int i = 0; i < n; i++) y[i] = x[i];
+}
+
+static void increments_scalaire(const double *h, int Nb, int n, double *d, double *e) {
+    for (int t = 0; t < n; t++) {
+        double delta = h[t + 2 * Nb] - h[t];
+        d[t] = h[t + Nb] * delta;
+        e[t] = delta;
+    }
+}
+
+static void correlation_scalaire(const double *P, const double *S, int n, double q, double *Y1) {
+    for (int i = 0; i < n; i++) Y1[i] = P[i] - S[i] * S[i] / q;
+}
+
+static int cherche_scalaire(const double *Y1, int n, double haut, double bas) {
+    for (int i = 0; i < n; i++) {
+        if (Y1[i] > haut || Y1[i] < bas) return i;
+    }
+    return n;
+}
+#endif
+
+static void moments_scalaire(const short *x, int n, long long *somme, long long *carres) {
+    long long s = 0, c = 0;
+    for (int i = 0; i < n; i++) {
+        s += x[i];
+        c += (long long)x[i] * x[i];
+    }
+    *somme = s;
+    *carres = c;
+}
+
+static void produit_iq_scalaire(const float *h, const float *re, const float *im, int n,
+                                float *yr, float *yi) {
+    float ar = 0.0f, ai = 0.0f;
+    for (int j = 0; j < n; j++) {
+        ar += h[j] * re[j];
+        ai += h[j] * im[j];
+    }
+    *yr = ar;
+    *yi = ai;
+}
+
+// atan2 by octant reduction and an odd polynomial on [0, 1]; the SIMD
+// versions below evaluate the same steps lane by lane
+#define ATAN_C1 -0.327622764f
+#define ATAN_C2  0.15931422f
+#define ATAN_C3 -0.0464964749f
+#define PI_F     3.14159265f
+#define PI_2_F   1.57079633f
+
+static inline float atan2_rapide(float y, float x) {
+    float ax = fabsf(x), ay = fabsf(y);
+    float mx = (ax > ay) ? ax : ay;
+    float mn = (ax > ay) ? ay : ax;
+    float a = mn / (mx > 1e-30f ? mx : 1e-30f);
+    float s = a * a;
+    float r = a + a * s * (ATAN_C1 + s * (ATAN_C2 + s * ATAN_C3));
+    if (ay > ax) r = PI_2_F - r;
+    if (x < 0.0f) r = PI_F - r;
+    return (y < 0.0f) ? -r : r;
+}
+
+static void phase_scalaire(const float *re, const float *im, int n, float *phi) {
+    for (int k = 0; k < n; k++) phi[k] = atan2_rapide(im[k], re[k]);
+}
+
+static void concordances_scalaire(const uint32_t *a, const uint32_t *b, int n, int *c) {
+    int i;
+    for (i = 0; i < n; i++) c[i] = 32 - 2 * __builtin_popcount(a[i] ^ b[i]);
+}
+
+#ifdef NOYAUX_X86
+// ===================================================
+// SSE2 kernels (2 doubles or 4 floats per vector)
+// ===================================================
+#ifndef DEMOD_ENTIER
+__attribute__((target("sse2")))
+static void convertit_sse2(const short *x, int n, double *y) {
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(x + i));
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+        _mm_storeu_pd(y + i, _mm_cvtepi32_pd(lo));
+        _mm_storeu_pd(y + i + 2, _mm_cvtepi32_pd(_mm_shuffle_epi32(lo, 0x4E)));
+        _mm_storeu_pd(y + i + 4, _mm_cvtepi32_pd(hi));
+        _mm_storeu_pd(y + i + 6, _mm_cvtepi32_pd(_mm_shuffle_epi32(hi, 0x4E)));
+    }
+    for (; i < n; i++) y[i] = x[i];
+}
+
+__attribute__((target("sse2")))
+static void increments_sse2(const double *h, int Nb, int n, double *d, double *e) {
+    int t = 0;
+    for (; t + 2 <= n; t += 2) {
+        __m128d delta = _mm_sub_pd(_mm_loadu_pd(h + t + 2 * Nb), _mm_loadu_pd(h + t));
+        _mm_storeu_pd(d + t, _mm_mul_pd(_mm_loadu_pd(h + t + Nb), delta));
+        _mm_storeu_pd(e + t, delta);
+    }
+    increments_scalaire(h + t, Nb, n - t, d + t, e + t);
+}
+
+__attribute__((target("sse2")))
+static void correlation_sse2(const double *P, const double *S, int n, double q, double *Y1) {
+    __m128d vq = _mm_set1_pd(q);
+    int i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d s = _mm_loadu_pd(S + i);
+        _mm_storeu_pd(Y1 + i, _mm_sub_pd(_mm_loadu_pd(P + i), _mm_div_pd(_mm_mul_pd(s, s), vq)));
+    }
+    correlation_scalaire(P + i, S + i, n - i, q, Y1 + i);
+}
+
+__attribute__((target("sse2")))
+static int cherche_sse2(const double *Y1, int n, double haut, double bas) {
+    __m128d vh = _mm_set1_pd(haut);
+    __m128d vb = _mm_set1_pd(bas);
+    int i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d y = _mm_loadu_pd(Y1 + i);
+        __m128d hors = _mm_or_pd(_mm_cmpgt_pd(y, vh), _mm_cmplt_pd(y, vb));
+        if (_mm_movemask_pd(hors)) break;
+    }
+    return i + cherche_scalaire(Y1 + i, n - i, haut, bas);
+}
+#endif
+
+// Pairwise squares from madd fit in 32 bits unsigned (at most 2^31);
+// they are widened to 64 bits before accumulating
+__attribute__((target("sse2")))
+static void moments_sse2(const short *x, int n, long long *somme, long long *carres) {
+    __m128i un = _mm_set1_epi16(1);
+    __m128i zero = _mm_setzero_si128();
+    __m128i vs = zero, vc = zero;
+    long long s, c, t[2];
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(x + i));
+        __m128i q = _mm_madd_epi16(v, v);
+        vs = _mm_add_epi32(vs, _mm_madd_epi16(v, un));
+        vc = _mm_add_epi64(vc, _mm_add_epi64(_mm_unpacklo_epi32(q, zero),
+                                             _mm_unpackhi_epi32(q, zero)));
+    }
+    moments_scalaire(x + i, n - i, &s, &c);
+    {
+        int u[4];
+        _mm_storeu_si128((__m128i *)u, vs);
+        s += (long long)u[0] + u[1] + u[2] + u[3];
+    }
+    _mm_storeu_si128((__m128i *)t, vc);
+    *somme = s;
+    *carres = c + t[0] + t[1];
+}
+
+__attribute__((target("sse2")))
+static void produit_iq_sse2(const float *h, const float *re, const float *im, int n,
+                            float *yr, float *yi) {
+    __m128 ar = _mm_setzero_ps(), ai = _mm_setzero_ps();
+    float t[4], sr, si;
+    int j = 0;
+    for (; j + 4 <= n; j += 4) {
+        __m128 vh = _mm_loadu_ps(h + j);
+        ar = _mm_add_ps(ar, _mm_mul_ps(vh, _mm_loadu_ps(re + j)));
+        ai = _mm_add_ps(ai, _mm_mul_ps(vh, _mm_loadu_ps(im + j)));
+    }
+    produit_iq_scalaire(h + j, re + j, im + j, n - j, &sr, &si);
+    _mm_storeu_ps(t, ar);
+    *yr = sr + (t[0] + t[1]) + (t[2] + t[3]);
+    _mm_storeu_ps(t, ai);
+    *yi = si + (t[0] + t[1]) + (t[2] + t[3]);
+}
+
+__attribute__((target("sse2")))
+static __m128 atan2_sse2(__m128 y, __m128 x) {
+    const __m128 signe = _mm_set1_ps(-0.0f);
+    __m128 ax = _mm_andnot_ps(signe, x);
+    __m128 ay = _mm_andnot_ps(signe, y);
+    __m128 mx = _mm_max_ps(_mm_max_ps(ax, ay), _mm_set1_ps(1e-30f));
+    __m128 a = _mm_div_ps(_mm_min_ps(ax, ay), mx);
+    __m128 s = _mm_mul_ps(a, a);
+    __m128 p = _mm_add_ps(_mm_set1_ps(ATAN_C2), _mm_mul_ps(s, _mm_set1_ps(ATAN_C3)));
+    __m128 r, m;
+    p = _mm_add_ps(_mm_set1_ps(ATAN_C1), _mm_mul_ps(s, p));
+    r = _mm_add_ps(a, _mm_mul_ps(_mm_mul_ps(a, s), p));
+    m = _mm_cmpgt_ps(ay, ax);
+    r = _mm_or_ps(_mm_and_ps(m, _mm_sub_ps(_mm_set1_ps(PI_2_F), r)), _mm_andnot_ps(m, r));
+    m = _mm_cmplt_ps(x, _mm_setzero_ps());
+    r = _mm_or_ps(_mm_and_ps(m, _mm_sub_ps(_mm_set1_ps(PI_F), r)), _mm_andnot_ps(m, r));
+    m = _mm_cmplt_ps(y, _mm_setzero_ps());
+    return _mm_xor_ps(r, _mm_and_ps(m, signe));
+}
+
+__attribute__((target("sse2")))
+static void phase_sse2(const float *re, const float *im, int n, float *phi) {
+    int k = 0;
+    for (; k + 4 <= n; k += 4) {
+        _mm_storeu_ps(phi + k, atan2_sse2(_mm_loadu_ps(im + k), _mm_loadu_ps(re + k)));
+    }
+    phase_scalaire(re + k, im + k, n - k, phi + k);
+}
+
+// SSE2 has no popcount instruction: bit-sliced count per 32-bit lane
+__attribute__((target("sse2")))
+static void concordances_sse2(const uint32_t *a, const uint32_t *b, int n, int *c) {
+    const __m128i m1 = _mm_set1_epi8(0x55);
+    const __m128i m2 = _mm_set1_epi8(0x33);
+    const __m128i m4 = _mm_set1_epi8(0x0f);
+    const __m128i m6 = _mm_set1_epi32(0x3f);
+    const __m128i trente_deux = _mm_set1_epi32(32);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i x = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(a + i)),
+                                  _mm_loadu_si128((const __m128i *)(b + i)));
+        x = _mm_sub_epi8(x, _mm_and_si128(_mm_srli_epi16(x, 1), m1));
+        x = _mm_add_epi8(_mm_and_si128(x, m2), _mm_and_si128(_mm_srli_epi16(x, 2), m2));
+        x = _mm_and_si128(_mm_add_epi8(x, _mm_srli_epi16(x, 4)), m4);
+        x = _mm_add_epi32(x, _mm_srli_epi32(x, 8));
+        x = _mm_and_si128(_mm_add_epi32(x, _mm_srli_epi32(x, 16)), m6);
+        _mm_storeu_si128((__m128i *)(c + i), _mm_sub_epi32(trente_deux, _mm_add_epi32(x, x)));
+    }
+    concordances_scalaire(a + i, b + i, n - i, c + i);
+}
+
+// ===================================================
+// AVX2 kernels (4 doubles or 8 floats per vector)
+// ===================================================
+#ifndef DEMOD_ENTIER
+__attribute__((target("avx2")))
+static void convertit_avx2(const short *x, int n, double *y) {
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i v = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)(x + i)));
+        _mm256_storeu_pd(y + i, _mm256_cvtepi32_pd(_mm256_castsi256_si128(v)));
+        _mm256_storeu_pd(y + i + 4, _mm256_cvtepi32_pd(_mm256_extracti128_si256(v, 1)));
+    }
+    for (; i < n; i++) y[i] = x[i];
+}
+
+__attribute__((target("avx2")))
+static void increments_avx2(const double *h, int Nb, int n, double *d, double *e) {
+    int t = 0;
+    for (; t + 4 <= n; t += 4) {
+        __m256d delta = _mm256_sub_pd(_mm256_loadu_pd(h + t + 2 * Nb), _mm256_loadu_pd(h + t));
+        _mm256_storeu_pd(d + t, _mm256_mul_pd(_mm256_loadu_pd(h + t + Nb), delta));
+        _mm256_storeu_pd(e + t, delta);
+    }
+    increments_scalaire(h + t, Nb, n - t, d + t, e + t);
+}
+
+__attribute__((target("avx2")))
+static void correlation_avx2(const double *P, const double *S, int n, double q, double *Y1) {
+    __m256d vq = _mm256_set1_pd(q);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d s = _mm256_loadu_pd(S + i);
+        _mm256_storeu_pd(Y1 + i, _mm256_sub_pd(_mm256_loadu_pd(P + i),
+                                               _mm256_div_pd(_mm256_mul_pd(s, s), vq)));
+    }
+    correlation_scalaire(P + i, S + i, n - i, q, Y1 + i);
+}
+
+__attribute__((target("avx2")))
+static int cherche_avx2(const double *Y1, int n, double haut, double bas) {
+    __m256d vh = _mm256_set1_pd(haut);
+    __m256d vb = _mm256_set1_pd(bas);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256d y0 = _mm256_loadu_pd(Y1 + i);
+        __m256d y1 = _mm256_loadu_pd(Y1 + i + 4);
+        __m256d hors = _mm256_or_pd(
+            _mm256_or_pd(_mm256_cmp_pd(y0, vh, _CMP_GT_OQ), _mm256_cmp_pd(y0, vb, _CMP_LT_OQ)),
+            _mm256_or_pd(_mm256_cmp_pd(y1, vh, _CMP_GT_OQ), _mm256_cmp_pd(y1, vb, _CMP_LT_OQ)));
+        if (_mm256_movemask_pd(hors)) break;
+    }
+    return i + cherche_scalaire(Y1 + i, n - i, haut, bas);
+}
+#endif
+
+__attribute__((target("avx2")))
+static void moments_avx2(const short *x, int n, long long *somme, long long *carres) {
+    __m256i un = _mm256_set1_epi16(1);
+    __m256i zero = _mm256_setzero_si256();
+    __m256i vs = zero, vc = zero;
+    long long s, c, t[4];
+    int u[8];
+    int i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(x + i));
+        __m256i q = _mm256_madd_epi16(v, v);
+        vs = _mm256_add_epi32(vs, _mm256_madd_epi16(v, un));
+        vc = _mm256_add_epi64(vc, _mm256_add_epi64(_mm256_unpacklo_epi32(q, zero),
+                                                   _mm256_unpackhi_epi32(q, zero)));
+    }
+    moments_scalaire(x + i, n - i, &s, &c);
+    _mm256_storeu_si256((__m256i *)u, vs);
+    _mm256_storeu_si256((__m256i *)t, vc);
+    *somme = s + u[0] + u[1] + u[2] + u[3] + u[4] + u[5] + u[6] + u[7];
+    *carres = c + t[0] + t[1] + t[2] + t[3];
+}
+
+__attribute__((target("avx2")))
+static void produit_iq_avx2(const float *h, const float *re, const float *im, int n,
+                            float *yr, float *yi) {
+    __m256 ar = _mm256_setzero_ps(), ai = _mm256_setzero_ps();
+    float t[8], sr, si;
+    int j = 0;
+    for (; j + 8 <= n; j += 8) {
+        __m256 vh = _mm256_loadu_ps(h + j);
+        ar = _mm256_add_ps(ar, _mm256_mul_ps(vh, _mm256_loadu_ps(re + j)));
+        ai = _mm256_add_ps(ai, _mm256_mul_ps(vh, _mm256_loadu_ps(im + j)));
+    }
+    produit_iq_scalaire(h + j, re + j, im + j, n - j, &sr, &si);
+    _mm256_storeu_ps(t, ar);
+    *yr = sr + ((t[0] + t[1]) + (t[2] + t[3])) + ((t[4] + t[5]) + (t[6] + t[7]));
+    _mm256_storeu_ps(t, ai);
+    *yi = si + ((t[0] + t[1]) + (t[2] + t[3])) + ((t[4] + t[5]) + (t[6] + t[7]));
+}
+
+__attribute__((target("avx2")))
+static __m256 atan2_avx2(__m256 y, __m256 x) {
+    const __m256 signe = _mm256_set1_ps(-0.0f);
+    __m256 ax = _mm256_andnot_ps(signe, x);
+    __m256 ay = _mm256_andnot_ps(signe, y);
+    __m256 mx = _mm256_max_ps(_mm256_max_ps(ax, ay), _mm256_set1_ps(1e-30f));
+    __m256 a = _mm256_div_ps(_mm256_min_ps(ax, ay), mx);
+    __m256 s = _mm256_mul_ps(a, a);
+    __m256 p = _mm256_add_ps(_mm256_set1_ps(ATAN_C2), _mm256_mul_ps(s, _mm256_set1_ps(ATAN_C3)));
+    __m256 r;
+    p = _mm256_add_ps(_mm256_set1_ps(ATAN_C1), _mm256_mul_ps(s, p));
+    r = _mm256_add_ps(a, _mm256_mul_ps(_mm256_mul_ps(a, s), p));
+    r = _mm256_blendv_ps(r, _mm256_sub_ps(_mm256_set1_ps(PI_2_F), r),
+                         _mm256_cmp_ps(ay, ax, _CMP_GT_OQ));
+    r = _mm256_blendv_ps(r, _mm256_sub_ps(_mm256_set1_ps(PI_F), r),
+                         _mm256_cmp_ps(x, _mm256_setzero_ps(), _CMP_LT_OQ));
+    return _mm256_xor_ps(r, _mm256_and_ps(_mm256_cmp_ps(y, _mm256_setzero_ps(), _CMP_LT_OQ),
+                                          signe));
+}
+
+__attribute__((target("avx2")))
+static void phase_avx2(const float *re, const float *im, int n, float *phi) {
+    int k = 0;
+    for (; k + 8 <= n; k += 8) {
+        _mm256_storeu_ps(phi + k, atan2_avx2(_mm256_loadu_ps(im + k), _mm256_loadu_ps(re + k)));
+    }
+    phase_scalaire(re + k, im + k, n - k, phi + k);
+}
+
+// Nibble lookup with pshufb, bytes summed per 32-bit lane by two madds
+__attribute__((target("avx2")))
+static void concordances_avx2(const uint32_t *a, const uint32_t *b, int n, int *c) {
+    const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                           0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i m4 = _mm256_set1_epi8(0x0f);
+    const __m256i un8 = _mm256_set1_epi8(1);
+    const __m256i un16 = _mm256_set1_epi16(1);
+    const __m256i trente_deux = _mm256_set1_epi32(32);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i x = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)(a + i)),
+                                     _mm256_loadu_si256((const __m256i *)(b + i)));
+        __m256i p = _mm256_add_epi8(
+            _mm256_shuffle_epi8(table, _mm256_and_si256(x, m4)),
+            _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(x, 4), m4)));
+        p = _mm256_madd_epi16(_mm256_maddubs_epi16(p, un8), un16);
+        _mm256_storeu_si256((__m256i *)(c + i),
+                            _mm256_sub_epi32(trente_deux, _mm256_add_epi32(p, p)));
+    }
+    concordances_scalaire(a + i, b + i, n - i, c + i);
+}
+#endif // NOYAUX_X86
+
+// The integer 1G kernels are the portable ones on every CPU
+#ifdef DEMOD_ENTIER
+#define NOYAUX_1G(isa) convertit_scalaire, increments_scalaire, \
+                       correlation_scalaire, cherche_scalaire
+#else
+#define NOYAUX_1G(isa) convertit_##isa, increments_##isa, correlation_##isa, cherche_##isa
+#endif
+
+NoyauxDemod noyaux = {
+    "scalar",
+    NOYAUX_1G(scalaire),
+    moments_scalaire,
+    produit_iq_scalaire,
+    phase_scalaire,
+    concordances_scalaire
+};
+
+void noyaux_init(void) {
+#ifdef NOYAUX_X86
+    static int fait = 0;
+    if (fait) return;
+    fait = 1;
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        NoyauxDemod avx2 = { "avx2", NOYAUX_1G(avx2), moments_avx2,
+                             produit_iq_avx2, phase_avx2, concordances_avx2 };
+        noyaux = avx2;
+    } else if (__builtin_cpu_supports("sse2")) {
+        NoyauxDemod sse2 = { "sse2", NOYAUX_1G(sse2), moments_sse2,
+                             produit_iq_sse2, phase_sse2, concordances_sse2 };
+        noyaux = sse2;
+    }
+#endif
+}
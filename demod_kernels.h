@@ -0,0 +1,147 @@
+/**********************************
+
+## Licence
+
+ Licence Creative Commons CC BY-NC-SA 
+
+## Auteurs et contributions
+
+- **Code original dec406_v7** : F4EHY (2020)
+- **Refactoring et support 2G** : Développement collaboratif (2025)
+- **Conformité T.018** : Implémentation complète BCH + MID database
+
+***********************************/
+
+// demod_kernels.h - Vectorized inner loops of the 1G demodulator and IQ front end
+#ifndef DEMOD_KERNELS_H
+#define DEMOD_KERNELS_H
+
+#include <stdint.h>
+
+// ===================================================
+// 1G correlator arithmetic
+// ===================================================
+// The default build correlates in double. Built with DEMOD_ENTIER
+// (make ENTIER=1) the 1G demodulator runs on integers only: samples and
+// outputs in 32 bits, running sums in 64 bits, for CPUs whose double
+// arithmetic is slow or scalar (ARM without double NEON lanes).
+#ifdef DEMOD_ENTIER
+typedef int32_t EchCorrel;      // Correlator history and increments
+typedef int32_t ValeurCorrel;   // Correlator output Y1
+typedef int64_t SommeCorrel;    // Running sums and sums of outputs
+#else
+typedef double EchCorrel;
+typedef double ValeurCorrel;
+typedef double SommeCorrel;
+#endif
+
+// ===================================================
+// Kernel table, selected at runtime
+// ===================================================
+typedef struct {
+    const char *nom;
+
+    /**
+     * Convert 16-bit samples to the correlator type
+     * @param x Input samples
+     * @param n Number of samples
+     * @param y Output values
+     */
+    void (*convertit)(const short *x, int n, EchCorrel *y);
+
+    /**
+     * Lag-product and window-sum increments of the correlator
+     * d[t] = h[t+Nb] * (h[t+2Nb] - h[t]), e[t] = h[t+2Nb] - h[t]
+     * With 16-bit samples the product stays below 2^31
+     * @param h History: sample x[t-2Nb] is h[t]
+     * @param Nb Lag in samples
+     * @param n Number of new samples
+     * @param d Output lag-product increments
+     * @param e Output window-sum increments
+     */
+    void (*increments)(const EchCorrel *h, int Nb, int n, EchCorrel *d, EchCorrel *e);
+
+#ifdef DEMOD_ENTIER
+    /**
+     * Mean-corrected correlation Y1 = (q*P - S*S) >> decalage from running sums
+     * @param P Running lag-product sums
+     * @param S Running window sums
+     * @param n Number of values
+     * @param q Normalization (4*Nb)
+     * @param decalage Right shift that brings the result within 32 bits
+     * @param Y1 Output correlation
+     */
+    void (*correlation)(const int64_t *P, const int64_t *S, int n, int q, int decalage,
+                        int32_t *Y1);
+#else
+    /**
+     * Mean-corrected correlation Y1 = P - S*S/q from running sums
+     * @param P Running lag-product sums
+     * @param S Running window sums
+     * @param n Number of values
+     * @param q Normalization (4*Nb)
+     * @param Y1 Output correlation
+     */
+    void (*correlation)(const double *P, const double *S, int n, double q, double *Y1);
+#endif
+
+    /**
+     * Find the first value outside [bas, haut]
+     * @param Y1 Correlation values
+     * @param n Number of values
+     * @param haut Upper threshold
+     * @param bas Lower threshold
+     * @return Index of the first Y1 > haut or Y1 < bas, n if none
+     */
+    int (*cherche)(const ValeurCorrel *Y1, int n, ValeurCorrel haut, ValeurCorrel bas);
+
+    /**
+     * Sum and sum of squares of 16-bit samples, exact
+     * @param x Input samples
+     * @param n Number of samples, at most 65536
+     * @param somme Output sum
+     * @param carres Output sum of squares
+     */
+    void (*moments)(const short *x, int n, long long *somme, long long *carres);
+
+    /**
+     * Real FIR taps applied to planar complex samples
+     * @param h Taps
+     * @param re Real parts, same length as h
+     * @param im Imaginary parts, same length as h
+     * @param n Number of taps
+     * @param yr Output real part
+     * @param yi Output imaginary part
+     */
+    void (*produit_iq)(const float *h, const float *re, const float *im, int n,
+                       float *yr, float *yi);
+
+    /**
+     * Phase of complex samples, atan2(im, re) within 2e-4 rad
+     * @param re Real parts
+     * @param im Imaginary parts
+     * @param n Number of samples
+     * @param phi Output phases in [-pi, pi]
+     */
+    void (*phase)(const float *re, const float *im, int n, float *phi);
+
+    /**
+     * Correlation of packed +/-1 chips, 32 per word (bit set = -1)
+     * c[i] = 32 - 2 * popcount(a[i] ^ b[i])
+     * @param a Received chip words
+     * @param b Reference chip words
+     * @param n Number of words
+     * @param c Output correlations, in [-32, 32]
+     */
+    void (*concordances)(const uint32_t *a, const uint32_t *b, int n, int *c);
+} NoyauxDemod;
+
+extern NoyauxDemod noyaux;
+
+/**
+ * Select the best kernels for the running CPU (SSE2/AVX2 on x86-64)
+ * Safe to call several times
+ */
+void noyaux_init(void);
+
+#endif // DEMOD_KERNELS_H
@@ -0,0 +1,96 @@
+/**********************************
+
+## Licence
+
+ Licence Creative Commons CC BY-NC-SA 
+
+## Auteurs et contributions
+
+- **Code original dec406_v7** : F4EHY (2020)
+- **Refactoring et support 2G** : Développement collaboratif (2025)
+- **Conformité T.018** : Implémentation complète BCH + MID database
+
+***********************************/
+
+// fft.c - In-place radix-2 complex FFT on planar float arrays
+//
+// Iterative decimation in time: bit-reversal permutation, then log2(n)
+// butterfly passes with twiddles read from a table at stride n/len.
+#include <stdlib.h>
+#include <math.h>
+#include "fft.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+int fft_init(PlanFFT *p, int n) {
+    int i, bits = 0;
+
+    fft_libere(p);
+    if (n < 2 || (n & (n - 1)) != 0) return 1;
+    while ((1 << bits) < n) bits++;
+
+    p->n = n;
+    p->cs = malloc(n / 2 * sizeof(float));
+    p->sn = malloc(n / 2 * sizeof(float));
+    p->inv = malloc(n * sizeof(int));
+    if (!p->cs || !p->sn || !p->inv) {
+        fft_libere(p);
+        return 1;
+    }
+    for (i = 0; i < n / 2; i++) {
+        p->cs[i] = (float)cos(2.0 * M_PI * i / n);
+        p->sn[i] = (float)sin(2.0 * M_PI * i / n);
+    }
+    for (i = 0; i < n; i++) {
+        int r = 0, b;
+        for (b = 0; b < bits; b++) {
+            if (i & (1 << b)) r |= 1 << (bits - 1 - b);
+        }
+        p->inv[i] = r;
+    }
+    return 0;
+}
+
+void fft_libere(PlanFFT *p) {
+    free(p->cs);
+    free(p->sn);
+    free(p->inv);
+    p->cs = NULL;
+    p->sn = NULL;
+    p->inv = NULL;
+    p->n = 0;
+}
+
+void fft_calcule(const PlanFFT *p, float *re, float *im, int inverse) {
+    const int n = p->n;
+    const float signe = inverse ? 1.0f : -1.0f;
+    int i, j, k, len;
+
+    for (i = 0; i < n; i++) {
+        j = p->inv[i];
+        if (j > i) {
+            float t = re[i]; re[i] = re[j]; re[j] = t;
+            t = im[i]; im[i] = im[j]; im[j] = t;
+        }
+    }
+
+    for (len = 2; len <= n; len <<= 1) {
+        int demi = len / 2;
+        int pas = n / len;
+        for (i = 0; i < n; i += len) {
+            for (k = 0; k < demi; k++) {
+                float wr = p->cs[k * pas];
+                float wi = signe * p->sn[k * pas];
+                int a = i + k, b = i + k + demi;
+                float tr = re[b] * wr - im[b] * wi;
+                float ti = re[b] * wi + im[b] * wr;
+                re[b] = re[a] - tr;
+                im[b] = im[a] - ti;
+                re[a] += tr;
+                im[a] += ti;
+            }
+        }
+    }
+}
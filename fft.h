@@ -0,0 +1,53 @@
+/**********************************
+
+## Licence
+
+ Licence Creative Commons CC BY-NC-SA 
+
+## Auteurs et contributions
+
+- **Code original dec406_v7** : F4EHY (2020)
+- **Refactoring et support 2G** : Développement collaboratif (2025)
+- **Conformité T.018** : Implémentation complète BCH + MID database
+
+***********************************/
+
+// fft.h - In-place radix-2 complex FFT on planar float arrays
+#ifndef FFT_H
+#define FFT_H
+
+// ===================================================
+// Precomputed plan for one size
+// ===================================================
+typedef struct {
+    int n;          // Size, a power of two
+    float *cs;      // cos(2*pi*k/n), k < n/2
+    float *sn;      // sin(2*pi*k/n), k < n/2
+    int *inv;       // Bit-reversal permutation
+} PlanFFT;
+
+/**
+ * Prepare twiddles and permutation for one size
+ * @param p Plan, zeroed by the caller before the first call
+ * @param n Size, a power of two >= 2
+ * @return 0 on success, 1 on bad size or allocation error
+ */
+int fft_init(PlanFFT *p, int n);
+
+/**
+ * Release a plan
+ * @param p Plan
+ */
+void fft_libere(PlanFFT *p);
+
+/**
+ * Transform in place, unnormalized in both directions
+ * X[k] = sum x[t] exp(-+2*pi*i*k*t/n)
+ * @param p Plan
+ * @param re Real parts, n values
+ * @param im Imaginary parts, n values
+ * @param inverse 0 for the forward transform (minus sign), 1 for the inverse
+ */
+void fft_calcule(const PlanFFT *p, float *re, float *im, int inverse);
+
+#endif // FFT_H
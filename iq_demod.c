@@ -0,0 +1,330 @@
+/**********************************
+
+## Licence
+
+ Licence Creative Commons CC BY-NC-SA 
+
+## Auteurs et contributions
+
+- **Code original dec406_v7** : F4EHY (2020)
+- **Refactoring et support 2G** : Développement collaboratif (2025)
+- **Conformité T.018** : Implémentation complète BCH + MID database
+
+***********************************/
+
+// iq_demod.c - Complex baseband input: channel filter and phase demodulator
+//
+// Raw IQ goes through a decimating low-pass channel filter, then the phase
+// of each sample is taken (atan2 kernel). The carrier is followed by a
+// frequency estimate from the phase steps and a slow phase loop; the
+// wrapped difference between sample and carrier phase is the +/-1.1 rad
+// biphase-L modulation itself, fed to the 1G demodulator like audio
+// samples. Unlike an FM discriminator, the output stays within +/-pi and
+// a noise click does not leave a 2*pi step behind it.
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "iq_demod.h"
+#include "demod_kernels.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Time constants (s): frequency estimate, phase loop
+#define IQ_TAU_DECALAGE 0.020
+#define IQ_TAU_PHASE 0.020
+
+// Largest step of the carrier estimate followed without atan2 (rad)
+#define IQ_PAS_PORTEUSE 0.01
+
+// Longest channel filter
+#define IQ_TAPS_MAX 4095
+
+static const int octets_ech[] = { 0, 2, 2, 4, 8 };
+
+FormatIQ iq_format(const char *nom) {
+    if (strcmp(nom, "cu8") == 0) return IQ_CU8;
+    if (strcmp(nom, "cs8") == 0) return IQ_CS8;
+    if (strcmp(nom, "cs16") == 0) return IQ_CS16;
+    if (strcmp(nom, "cf32") == 0) return IQ_CF32;
+    return IQ_AUCUN;
+}
+
+int iq_init(DemodIQ *q, FormatIQ format, int f_iq, double bande) {
+    int facteur;
+
+    iq_libere(q);
+    if (format == IQ_AUCUN || f_iq <= 0 || bande <= 0.0) return 1;
+    q->format = format;
+    q->f_iq = f_iq;
+    facteur = f_iq / IQ_F_CIBLE;
+    if (facteur < 1) facteur = 1;
+    q->f_sortie = f_iq / facteur;
+
+    q->re = malloc(IQ_BLOC * sizeof(float));
+    q->im = malloc(IQ_BLOC * sizeof(float));
+    q->brut = malloc(IQ_BLOC * octets_ech[format]);
+    q->sortie = malloc(IQ_BLOC * sizeof(short));
+    if (!q->re || !q->im || !q->brut || !q->sortie ||
+        filtre_iq_init(&q->filtre, f_iq, facteur, bande) != 0 ||
+        phase_iq_init(&q->demod, q->f_sortie, IQ_BLOC) != 0) {
+        iq_libere(q);
+        return 1;
+    }
+    return 0;
+}
+
+void iq_libere(DemodIQ *q) {
+    free(q->re);
+    free(q->im);
+    filtre_iq_libere(&q->filtre);
+    phase_iq_libere(&q->demod);
+    free(q->brut);
+    free(q->sortie);
+    q->re = NULL;
+    q->im = NULL;
+    q->brut = NULL;
+    q->sortie = NULL;
+}
+
+int iq_octets(FormatIQ format) {
+    return octets_ech[format];
+}
+
+void iq_convertit(FormatIQ format, const void *brut, int n, float *re, float *im) {
+    int k;
+
+    switch (format) {
+    case IQ_CU8: {
+        const unsigned char *p = brut;
+        for (k = 0; k < n; k++) {
+            re[k] = (p[2 * k] - 127.5f) / 128.0f;
+            im[k] = (p[2 * k + 1] - 127.5f) / 128.0f;
+        }
+        break;
+    }
+    case IQ_CS8: {
+        const signed char *p = brut;
+        for (k = 0; k < n; k++) {
+            re[k] = p[2 * k] / 128.0f;
+            im[k] = p[2 * k + 1] / 128.0f;
+        }
+        break;
+    }
+    case IQ_CS16: {
+        const unsigned char *p = brut;
+        for (k = 0; k < n; k++) {
+            re[k] = (short)(p[4 * k] | (p[4 * k + 1] << 8)) / 32768.0f;
+            im[k] = (short)(p[4 * k + 2] | (p[4 * k + 3] << 8)) / 32768.0f;
+        }
+        break;
+    }
+    case IQ_CF32: {
+        const float *p = brut;
+        for (k = 0; k < n; k++) {
+            re[k] = p[2 * k];
+            im[k] = p[2 * k + 1];
+        }
+        break;
+    }
+    default:
+        for (k = 0; k < n; k++) {
+            re[k] = 0.0f;
+            im[k] = 0.0f;
+        }
+        break;
+    }
+}
+
+static inline double enroule(double a) {
+    if (a > M_PI) a -= 2.0 * M_PI;
+    else if (a < -M_PI) a += 2.0 * M_PI;
+    return a;
+}
+
+// ===================================================
+// Channel filter
+// ===================================================
+int filtre_iq_init(FiltreIQ *f, int f_ech, int facteur, double bande) {
+    double arret, transition;
+    double f_sortie;
+    int i;
+
+    filtre_iq_libere(f);
+    if (f_ech <= 0 || facteur < 1 || bande <= 0.0) return 1;
+    f->facteur = facteur;
+    f_sortie = (double)(f_ech / facteur);
+
+    // Blackman-windowed sinc, flat to bande, stopband from twice bande
+    // (or earlier, so that nothing aliases into the passband)
+    arret = 2.0 * bande;
+    if (arret > f_sortie - bande) arret = f_sortie - bande;
+    transition = arret - bande;
+    if (transition <= 0.0) {
+        f->ntaps = 1;
+    } else {
+        f->ntaps = (int)(5.5 * f_ech / transition) | 1;
+        if (f->ntaps > IQ_TAPS_MAX) f->ntaps = IQ_TAPS_MAX;
+    }
+    f->h = malloc(f->ntaps * sizeof(float));
+    f->hist_re = calloc(2 * f->ntaps, sizeof(float));
+    f->hist_im = calloc(2 * f->ntaps, sizeof(float));
+    if (!f->h || !f->hist_re || !f->hist_im) {
+        filtre_iq_libere(f);
+        return 1;
+    }
+    if (f->ntaps == 1) {
+        f->h[0] = 1.0f;
+    } else {
+        double fc = (bande + arret) / 2.0 / f_ech;
+        double somme = 0.0;
+        double *h = malloc(f->ntaps * sizeof(double));
+        int m = f->ntaps - 1;
+        if (!h) {
+            filtre_iq_libere(f);
+            return 1;
+        }
+        for (i = 0; i < f->ntaps; i++) {
+            double t = i - m / 2.0;
+            double sinc = (t == 0.0) ? 2.0 * fc : sin(2.0 * M_PI * fc * t) / (M_PI * t);
+            double w = 0.42 - 0.5 * cos(2.0 * M_PI * i / m) + 0.08 * cos(4.0 * M_PI * i / m);
+            h[i] = sinc * w;
+            somme += h[i];
+        }
+        for (i = 0; i < f->ntaps; i++) f->h[i] = (float)(h[i] / somme);
+        free(h);
+    }
+    f->pos = 0;
+    f->phase = 0;
+    noyaux_init();
+    return 0;
+}
+
+void filtre_iq_libere(FiltreIQ *f) {
+    free(f->h);
+    free(f->hist_re);
+    free(f->hist_im);
+    f->h = NULL;
+    f->hist_re = NULL;
+    f->hist_im = NULL;
+    f->ntaps = 0;
+}
+
+int filtre_iq_bloc(FiltreIQ *f, float *re, float *im, int n) {
+    int i, m = 0;
+
+    // Evaluated once per output sample; outputs overwrite the input
+    // from the start, never ahead of the sample being read
+    for (i = 0; i < n; i++) {
+        f->hist_re[f->pos] = re[i];
+        f->hist_re[f->pos + f->ntaps] = re[i];
+        f->hist_im[f->pos] = im[i];
+        f->hist_im[f->pos + f->ntaps] = im[i];
+        if (++f->pos == f->ntaps) f->pos = 0;
+        if (++f->phase < f->facteur) continue;
+        f->phase = 0;
+        noyaux.produit_iq(f->h, f->hist_re + f->pos, f->hist_im + f->pos, f->ntaps,
+                          &re[m], &im[m]);
+        m++;
+    }
+    return m;
+}
+
+// ===================================================
+// Phase demodulator
+// ===================================================
+int phase_iq_init(PhaseIQ *d, int f_ech, int n_max) {
+    phase_iq_libere(d);
+    d->psi = malloc(n_max * sizeof(float));
+    if (!d->psi) return 1;
+    d->alpha = 1.0 / (IQ_TAU_DECALAGE * f_ech);
+    d->kp = 2.0 / (IQ_TAU_PHASE * f_ech);
+    d->ki = d->kp * d->kp / 4.0;
+    phase_iq_raz(d);
+    noyaux_init();
+    return 0;
+}
+
+void phase_iq_raz(PhaseIQ *d) {
+    d->re_prec = 0.0f;
+    d->im_prec = 0.0f;
+    d->c_re = 0.0;
+    d->c_im = 0.0;
+    d->theta = 0.0;
+    d->w = 0.0;
+}
+
+void phase_iq_libere(PhaseIQ *d) {
+    free(d->psi);
+    d->psi = NULL;
+}
+
+void phase_iq_bloc(PhaseIQ *d, const float *re, const float *im, int n, short *out) {
+    double f = atan2(d->c_im, d->c_re);
+    int i;
+
+    noyaux.phase(re, im, n, d->psi);
+    for (i = 0; i < n; i++) {
+        const double prec_re = d->c_re, prec_im = d->c_im;
+        double e, y;
+
+        // Frequency: circular mean of the phase steps. Every step counts
+        // the same, so the few wild steps of an FM click barely move it
+        {
+            float pr = re[i] * d->re_prec + im[i] * d->im_prec;
+            float pq = im[i] * d->re_prec - re[i] * d->im_prec;
+            float norme = sqrtf(pr * pr + pq * pq);
+            if (norme > 0.0f) {
+                double croix, point;
+                d->c_re += d->alpha * (pr / norme - d->c_re);
+                d->c_im += d->alpha * (pq / norme - d->c_im);
+                // Its angle moves by atan(croix / point); the ratio is
+                // exact to third order for the small steps of a settled
+                // estimate, atan2 takes over while it forms
+                croix = prec_re * d->c_im - prec_im * d->c_re;
+                point = prec_re * d->c_re + prec_im * d->c_im;
+                if (point > 0.0 && fabs(croix) < IQ_PAS_PORTEUSE * point) {
+                    f = enroule(f + croix / point);
+                } else {
+                    f = atan2(d->c_im, d->c_re);
+                }
+            }
+        }
+        d->re_prec = re[i];
+        d->im_prec = im[i];
+
+        // Phase: second-order loop around the frequency estimate
+        d->theta = enroule(d->theta + f + d->w);
+        e = enroule(d->psi[i] - d->theta);
+        d->w += d->ki * e;
+        d->theta = enroule(d->theta + d->kp * e);
+
+        y = floor(e * IQ_ECHELLE + 0.5);
+        out[i] = (short)y;
+    }
+}
+
+// ===================================================
+// IQ front end
+// ===================================================
+int iq_bloc(DemodIQ *q, const void *brut, int n, short *out) {
+    int m;
+
+    iq_convertit(q->format, brut, n, q->re, q->im);
+    m = filtre_iq_bloc(&q->filtre, q->re, q->im, n);
+    phase_iq_bloc(&q->demod, q->re, q->im, m, out);
+    return m;
+}
+
+int iq_lit(DemodIQ *q, FILE *fp, const short **ech) {
+    int n, m;
+
+    do {
+        n = fread(q->brut, octets_ech[q->format], IQ_BLOC, fp);
+        if (n <= 0) return 0;
+        m = iq_bloc(q, q->brut, n, q->sortie);
+    } while (m == 0);
+    *ech = q->sortie;
+    return m;
+}
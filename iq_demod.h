@@ -0,0 +1,209 @@
+/**********************************
+
+## Licence
+
+ Licence Creative Commons CC BY-NC-SA 
+
+## Auteurs et contributions
+
+- **Code original dec406_v7** : F4EHY (2020)
+- **Refactoring et support 2G** : Développement collaboratif (2025)
+- **Conformité T.018** : Implémentation complète BCH + MID database
+
+***********************************/
+
+// iq_demod.h - Complex baseband input: channel filter and phase demodulator
+#ifndef IQ_DEMOD_H
+#define IQ_DEMOD_H
+
+#include <stdio.h>
+
+// Channel filter half-width (Hz): 1G spectrum plus tuning error
+#define IQ_BANDE_DEFAUT 6000.0
+
+// Output rate aimed at by the channel decimator (Hz)
+#define IQ_F_CIBLE 48000
+
+// Complex samples read per block
+#define IQ_BLOC 16384
+
+// Output units per radian of phase (+/-1.1 rad gives about +/-9000)
+#define IQ_ECHELLE 8192.0
+
+// ===================================================
+// Sample formats
+// ===================================================
+typedef enum {
+    IQ_AUCUN = 0,
+    IQ_CU8,     // Unsigned 8-bit I/Q (rtl_sdr)
+    IQ_CS8,     // Signed 8-bit I/Q (hackrf_transfer)
+    IQ_CS16,    // Signed 16-bit little-endian I/Q
+    IQ_CF32     // 32-bit float I/Q (GNU Radio, SDR++)
+} FormatIQ;
+
+// ===================================================
+// Decimating low-pass channel filter
+// ===================================================
+typedef struct {
+    int facteur;        // Decimation ratio
+    // Polyphase decimating FIR (only kept outputs are computed)
+    float *h;
+    float *hist_re;     // History, stored twice for contiguous reads
+    float *hist_im;
+    int ntaps;
+    int pos;
+    int phase;
+} FiltreIQ;
+
+// ===================================================
+// Phase demodulator with carrier tracking
+// ===================================================
+typedef struct {
+    float *psi;         // Phase of the current block
+    float re_prec;      // Previous sample
+    float im_prec;
+    double c_re;        // Mean of z[k] * conj(z[k-1]): carrier offset
+    double c_im;
+    double alpha;       // Offset averaging weight
+    double theta;       // Carrier phase
+    double w;           // Frequency correction from the phase loop
+    double kp;          // Phase loop gains (critically damped)
+    double ki;
+} PhaseIQ;
+
+// ===================================================
+// IQ front end state
+// ===================================================
+typedef struct {
+    FormatIQ format;
+    int f_iq;           // Input sample rate (Hz)
+    int f_sortie;       // Output sample rate (Hz)
+    FiltreIQ filtre;    // Channel filter
+    // Phase demodulator
+    float *re;          // Channel samples
+    float *im;
+    PhaseIQ demod;
+    // Stream reading
+    unsigned char *brut;
+    short *sortie;
+} DemodIQ;
+
+/**
+ * Parse a sample format name
+ * @param nom "cu8", "cs8", "cs16" or "cf32"
+ * @return Format, IQ_AUCUN if unknown
+ */
+FormatIQ iq_format(const char *nom);
+
+/**
+ * Bytes per complex sample
+ * @param format Sample format
+ * @return Size in bytes, 0 for IQ_AUCUN
+ */
+int iq_octets(FormatIQ format);
+
+/**
+ * Convert raw samples to planar float, full scale 1.0
+ * @param format Sample format
+ * @param brut Raw samples
+ * @param n Number of complex samples
+ * @param re Output real parts
+ * @param im Output imaginary parts
+ */
+void iq_convertit(FormatIQ format, const void *brut, int n, float *re, float *im);
+
+/**
+ * Configure a decimating channel filter: Blackman-windowed sinc, flat to
+ * bande, stopband from twice bande or earlier so nothing aliases into it
+ * @param f Filter state, zeroed by the caller before the first call
+ * @param f_ech Input sample rate (Hz)
+ * @param facteur Decimation ratio
+ * @param bande Passband half-width (Hz)
+ * @return 0 on success, 1 on error
+ */
+int filtre_iq_init(FiltreIQ *f, int f_ech, int facteur, double bande);
+
+/**
+ * Release a channel filter
+ * @param f Filter state
+ */
+void filtre_iq_libere(FiltreIQ *f);
+
+/**
+ * Filter and decimate a block in place
+ * @param f Filter state
+ * @param re Real parts, replaced by the output from the start
+ * @param im Imaginary parts, likewise
+ * @param n Number of input samples
+ * @return Number of output samples
+ */
+int filtre_iq_bloc(FiltreIQ *f, float *re, float *im, int n);
+
+/**
+ * Configure a phase demodulator
+ * @param d Demodulator state, zeroed by the caller before the first call
+ * @param f_ech Sample rate (Hz)
+ * @param n_max Largest block passed to phase_iq_bloc()
+ * @return 0 on success, 1 on allocation error
+ */
+int phase_iq_init(PhaseIQ *d, int f_ech, int n_max);
+
+/**
+ * Forget the carrier, as before the first sample
+ * @param d Demodulator state
+ */
+void phase_iq_raz(PhaseIQ *d);
+
+/**
+ * Release a phase demodulator
+ * @param d Demodulator state
+ */
+void phase_iq_libere(PhaseIQ *d);
+
+/**
+ * Phase-demodulate complex baseband samples
+ * @param d Demodulator state
+ * @param re Real parts
+ * @param im Imaginary parts
+ * @param n Number of samples, at most n_max
+ * @param out Phase relative to the carrier, IQ_ECHELLE units per radian
+ */
+void phase_iq_bloc(PhaseIQ *d, const float *re, const float *im, int n, short *out);
+
+/**
+ * Configure the IQ front end
+ * @param q Front end state, zeroed by the caller before the first call
+ * @param format Sample format
+ * @param f_iq Input sample rate (Hz)
+ * @param bande Channel filter half-width (Hz)
+ * @return 0 on success, 1 on error
+ */
+int iq_init(DemodIQ *q, FormatIQ format, int f_iq, double bande);
+
+/**
+ * Release front end buffers
+ * @param q Front end state
+ */
+void iq_libere(DemodIQ *q);
+
+/**
+ * Filter, decimate and phase-demodulate a block of IQ samples
+ * @param q Front end state
+ * @param brut Raw samples in the configured format
+ * @param n Number of complex samples, at most IQ_BLOC
+ * @param out Phase samples at f_sortie, IQ_ECHELLE units per radian
+ * @return Number of output samples
+ */
+int iq_bloc(DemodIQ *q, const void *brut, int n, short *out);
+
+/**
+ * Read and demodulate IQ samples from a stream
+ * The span stays valid until the next call
+ * @param q Front end state
+ * @param fp Raw IQ stream
+ * @param ech Set to the first phase sample of the span
+ * @return Number of samples, 0 on EOF
+ */
+int iq_lit(DemodIQ *q, FILE *fp, const short **ech);
+
+#endif // IQ_DEMOD_H
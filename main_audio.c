@@ -18,9 +18,16 @@
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <sys/stat.h>
 #include "dec406.h"
 #include "audio_capture.h"
 #include "display_utils.h"
+#include "batch.h"
+#include "channelizer.h"
+#include "demod_2g.h"
+
+// Samples per read from a mapped WAV file
+#define WAV_BLOCK 65536
 
 // ===================================================
 // Function prototypes
@@ -28,8 +35,12 @@
 void print_help(const char* program_name);
 int is_hex_string(const char* str);
 int is_wav_file(const char* filename);
+int is_directory(const char* path);
 void decode_hex_string(const char* hex_str);
-void hex_string_to_bits(const char* hex_str, uint8_t* bits, int bit_count);
+int decode_audio_stream(FILE *fp, const WavMappe *wav, int stop_on_timeout, DemodIQ *iq);
+int decode_iq_input(const char *path, int n_threads);
+int decode_canaux(FILE *fp, int stop_on_timeout);
+int decode_sgb(FILE *fp, int stop_on_timeout, int n_threads);
 
 // ===================================================
 // Help function
@@ -40,7 +51,7 @@ void print_help(const char* program_name) {
     
     printf("USAGE MODES:\n");
     printf("  1. Real-time audio capture (via sox):\n");
-    printf("     sox -t alsa default -t wav - lowpass 3000 highpass 10 gain -l 6 2>/dev/null | %s\n\n", program_name);
+    printf("     sox -t alsa default -t wav - 2>/dev/null | %s --filtre\n\n", program_name);
     
     printf("  2. WAV file:\n");
     printf("     %s recording.wav\n\n", program_name);
@@ -48,14 +59,46 @@ void print_help(const char* program_name) {
     printf("  3. Hexadecimal string:\n");
     printf("     %s FFFED08E39048D158AC01E3AA482856824CE\n\n", program_name);
     
+    printf("  4. Batch of WAV files or directories (parallel):\n");
+    printf("     %s wav_pour_tests/ other.wav\n\n", program_name);
+    
+    printf("  5. Raw IQ from an SDR, on stdin or from a file:\n");
+    printf("     rtl_sdr -f 406028000 -s 1024000 - | %s --iq=cu8 --f_iq=1024000\n", program_name);
+    printf("     All T.012 channels at once, with the tuner centre frequency:\n");
+    printf("     rtl_sdr -f 406050000 -s 250000 - | %s --iq=cu8 --f_iq=250000 --canaux=406050000\n", program_name);
+    printf("     2G (T.018) bursts, at least 153600 Hz:\n");
+    printf("     rtl_sdr -f 406050000 -s 1024000 - | %s --iq=cu8 --f_iq=1024000 --sgb\n\n", program_name);
+    
     printf("OPTIONS:\n");
     printf("  --help              Display this help\n");
     printf("  --osm               Open position in OpenStreetMap\n");
     printf("  --une_minute        55-second timeout (for scan406)\n");
     printf("  --verbose           Verbose mode with statistics\n");
     printf("  --canal1            Use right audio channel\n");
+    printf("  --decim             Decimate high-rate input automatically\n");
+    printf("  --decim=N           Decimate input by integer ratio N\n");
+    printf("  --filtre            Built-in DC blocker, band-pass and decimation filter\n");
+    printf("  --passe_haut=F      Front end high-pass corner in Hz (default: 10)\n");
+    printf("  --passe_bas=F       Front end low-pass corner in Hz (default: 3000)\n");
+    printf("  --raw=F             Headerless 16-bit mono input at F Hz on stdin\n");
+    printf("  --iq=FMT            Raw IQ input: cu8, cs8, cs16 or cf32\n");
+    printf("  --f_iq=F            IQ sample rate in Hz\n");
+    printf("  --iq_bande=F        IQ channel filter half-width in Hz (default: 6000)\n");
+    printf("  --canaux=F          Decode every T.012 channel in the IQ band, tuner at F Hz\n");
+    printf("  --sgb               Decode 2G (T.018) bursts from the IQ input\n");
+    printf("  --sgb=fft           Same, searching all code phases by FFT: more sensitive,\n");
+    printf("                      more CPU, carrier bins spread over --threads=N\n");
+    printf("  --continu           Keep correlator and thresholds from one frame to the next\n");
+    printf("  --sans_porte        Run the correlator on every sample, even between bursts\n");
+    printf("  --horodatage        Print the time of each sync from the sample clock\n");
+    printf("                      (UTC on stdin, from the start of a file)\n");
+    printf("  --horodatage=T      Same, in UTC with sample 0 at UNIX time T\n");
+    printf("  --threads=N         Worker threads for batches, or split one WAV file\n");
+    printf("                      into overlapping segments (0: one per CPU)\n");
     printf("  --2 to --100        Threshold coefficient (default: 100)\n");
-    printf("  --M1 to --M10       Max level for threshold (default: M3)\n\n");
+    printf("  --M1 to --M10       Max level for threshold, 10^n (default: M4)\n");
+    printf("  --banc              Try coefficients 100, 50, 20, 10, 5, 2 on each burst\n");
+    printf("  --banc=c[:M],...    Try these coefficients (and max levels) as well\n\n");
     
     printf("SUPPORTED HEX FORMATS:\n");
     printf("  - 28 characters (112 bits): 1G short frame\n");
@@ -84,6 +127,11 @@ int is_hex_string(const char* str) {
     return (len == 28 || len == 36 || len == 64);
 }
 
+int is_directory(const char* path) {
+    struct stat st;
+    return stat(path, &st) == 0 && S_ISDIR(st.st_mode);
+}
+
 int is_wav_file(const char* filename) {
     size_t len = strlen(filename);
     if (len < 4) return 0;
@@ -92,32 +140,6 @@ int is_wav_file(const char* filename) {
     return (strcasecmp(ext, ".wav") == 0);
 }
 
-// ===================================================
-// Hex to bits conversion
-// ===================================================
-void hex_string_to_bits(const char* hex_str, uint8_t* bits, int bit_count) {
-    int hex_len = strlen(hex_str);
-    
-    for (int i = 0; i < hex_len && (i * 4) < bit_count; i++) {
-        char c = tolower(hex_str[i]);
-        int value;
-        
-        if (c >= 'a' && c <= 'f') {
-            value = c - 'a' + 10;
-        } else if (c >= '0' && c <= '9') {
-            value = c - '0';
-        } else {
-            value = 0;
-            fprintf(stderr, "Warning: non-hex character '%c' at position %d\n", c, i);
-        }
-        
-        // Convert each hex digit to 4 bits
-        for (int j = 0; j < 4 && (i * 4 + j) < bit_count; j++) {
-            bits[i * 4 + j] = (value >> (3 - j)) & 1;
-        }
-    }
-}
-
 // ===================================================
 // Hex string decoding
 // ===================================================
@@ -137,21 +159,291 @@ void decode_hex_string(const char* hex_str) {
         return;
     }
     
-    // Allocate bit array
-    uint8_t* bits = malloc(frame_bits * sizeof(uint8_t));
-    if (!bits) {
-        fprintf(stderr, "Memory allocation error\n");
-        return;
+    // Convert hex string to a packed frame
+    Trame406 trame;
+    trame406_efface(&trame, frame_bits);
+    int invalides = trame406_depuis_hex(&trame, hex_str, 0);
+    if (invalides > 0) {
+        fprintf(stderr, "Warning: %d non-hex characters read as 0\n", invalides);
+    }
+    
+    decode_beacon(&trame);
+}
+
+// ===================================================
+// Audio stream decoding
+// ===================================================
+typedef struct {
+    int frames_decoded;
+    int f_ech;
+    long long last_frame;   // Sample index of the last frame end
+} StreamState;
+
+static void frame_received(const TrameDemod *trame, void *user) {
+    StreamState *st = user;
+    
+    affiche_horodatage(trame->ech_sync, trame->t_sync, st->f_ech);
+    decode_1g_soft(&trame->bits, trame->fiabilite);
+    st->frames_decoded++;
+    st->last_frame = trame->ech;
+    printf("\n--- Frame %d decoded ---\n", st->frames_decoded);
+}
+
+// Feed a whole stream to a decoder, return the number of frames
+// The 55 s timeout runs on the sample clock, so a quiet pipe still
+// times out on schedule and a file gives the same result every run.
+// With iq set, the stream holds raw IQ demodulated by that front end;
+// with wav set, samples come from that mapped file and fp is unused.
+int decode_audio_stream(FILE *fp, const WavMappe *wav, int stop_on_timeout, DemodIQ *iq) {
+    DemodConfig cfg;
+    Demod1G *demod;
+    StreamState st;
+    const short *samples;
+    short *wav_buffer = NULL;
+    size_t wav_pos = 0;
+    int n;
+    long long timeout;
+    
+    demod_config_audio(&cfg);
+    if (iq) {
+        cfg.f_ech = iq->f_sortie;
+    }
+    st.frames_decoded = 0;
+    st.f_ech = cfg.f_ech;
+    st.last_frame = 0;
+    if (wav) {
+        wav_buffer = malloc(WAV_BLOCK * sizeof(short));
+        if (!wav_buffer) {
+            fprintf(stderr, "Memory allocation error\n");
+            return 0;
+        }
     }
+    demod = demod_cree(&cfg, frame_received, &st);
+    if (!demod) {
+        free(wav_buffer);
+        return 0;
+    }
+    timeout = (long long)TIMEOUT_MINUTE_S * cfg.f_ech;
     
-    // Convert hex string to bits
-    memset(bits, 0, frame_bits * sizeof(uint8_t));
-    hex_string_to_bits(hex_str, bits, frame_bits);
+    for (;;) {
+        if (wav) {
+            n = wav_mappe_lit(wav, wav_pos, WAV_BLOCK, wav_buffer, &samples);
+            wav_pos += n;
+        } else if (iq) {
+            n = iq_lit(iq, fp, &samples);
+        } else {
+            n = lit_span(fp, &samples);
+        }
+        if (n <= 0) break;
+        demod_alimente(demod, samples, n);
+        
+        if (opt_minute == 1 && demod_position(demod) - st.last_frame > timeout) {
+            fprintf(stderr, "Plus de 55s\n");
+            if (stop_on_timeout) break;
+            demod_vide(demod);
+            demod_reinit(demod);
+            st.last_frame = demod_position(demod);
+        }
+    }
+    if (n == 0) {
+        fprintf(stderr, "Fin de lecture wav\n");
+    }
+    demod_vide(demod);
+    if (cfg.porte && opt_verbeux) {
+        fprintf(stderr, "Correlator ran on %.1f%% of the samples\n",
+                100.0 * demod_charge(demod));
+    }
     
-    // Call decoder with bits
-    decode_beacon(bits, frame_bits);
+    demod_detruit(demod);
+    free(wav_buffer);
+    return st.frames_decoded;
+}
+
+// ===================================================
+// All-channel IQ decoding
+// ===================================================
+typedef struct {
+    int frames_decoded;
+    long long last_frame;   // Input sample of the last frame end
+} CanauxState;
+
+static void frame_canal(const TrameCanal *trame, void *user) {
+    CanauxState *st = user;
     
-    free(bits);
+    printf("Channel %c %.3f MHz, level %.1f dB\n", 'A' + trame->canal,
+           trame->f_canal / 1e6, trame->niveau);
+    affiche_horodatage(trame->trame.ech_sync, trame->trame.t_sync, f_iq);
+    printf("%s frame captured (%d bits)\n",
+           trame->trame.bits.longueur == 112 ? "Short" : "Long", trame->trame.bits.longueur);
+    decode_1g_soft(&trame->trame.bits, trame->trame.fiabilite);
+    st->frames_decoded++;
+    st->last_frame = trame->trame.ech;
+    printf("\n--- Frame %d decoded ---\n", st->frames_decoded);
+}
+
+// Split a wideband IQ stream into the T.012 channels and decode them all
+// Return the number of frames, -1 if no channel fits the band
+int decode_canaux(FILE *fp, int stop_on_timeout) {
+    DemodConfig cfg;
+    Canaliseur *c;
+    CanauxState st;
+    unsigned char *brut;
+    const int octets = iq_octets(format_iq);
+    const long long timeout = (long long)TIMEOUT_MINUTE_S * f_iq;
+    int n;
+    
+    demod_config_audio(&cfg);
+    st.frames_decoded = 0;
+    st.last_frame = 0;
+    c = canaliseur_cree(format_iq, f_iq, f_centre_canaux, &cfg, frame_canal, &st);
+    brut = malloc((size_t)IQ_BLOC * octets);
+    if (!c || !brut) {
+        fprintf(stderr, "Error: Cannot set up channelizer\n");
+        canaliseur_detruit(c);
+        free(brut);
+        return -1;
+    }
+    canaliseur_affiche(c);
+    
+    while ((n = fread(brut, octets, IQ_BLOC, fp)) > 0) {
+        canaliseur_alimente(c, brut, n);
+        
+        if (opt_minute == 1 && canaliseur_position(c) - st.last_frame > timeout) {
+            fprintf(stderr, "Plus de 55s\n");
+            if (stop_on_timeout) break;
+            st.last_frame = canaliseur_position(c);
+        }
+    }
+    canaliseur_termine(c);
+    if (opt_verbeux && canaliseur_perdues(c) > 0) {
+        fprintf(stderr, "Channelizer dropped %lld frames (hold buffer full)\n",
+                canaliseur_perdues(c));
+    }
+    
+    canaliseur_detruit(c);
+    free(brut);
+    return st.frames_decoded;
+}
+
+// ===================================================
+// 2G IQ decoding
+// ===================================================
+static void frame_sgb(const Trame2G *trame, void *user) {
+    CanauxState *st = user;
+    char hex[65];
+    
+    // 250 bits as 64 hex digits, padded with zeros like the hex input
+    trame406_hex(&trame->bits, 0, TRAME406_BITS_MAX, 1, hex);
+    
+    printf("2G burst, carrier %+.0f Hz, chip clock %+.1f ppm, Eb/N0 %.1f dB\n",
+           trame->decalage, trame->derive, trame->eb_n0);
+    affiche_horodatage(trame->ech, (double)trame->ech, f_iq);
+    printf("Hexadecimal: %s\n", hex);
+    decode_2g_soft(&trame->bits, trame->fiabilite);
+    st->frames_decoded++;
+    st->last_frame = trame->ech + (long long)f_iq;
+    printf("\n--- Frame %d decoded ---\n", st->frames_decoded);
+}
+
+// Search an IQ stream for 2G bursts and decode them
+// Return the number of bursts, -1 if the receiver cannot be set up
+int decode_sgb(FILE *fp, int stop_on_timeout, int n_threads) {
+    Demod2G *d;
+    CanauxState st;
+    unsigned char *brut;
+    const int octets = iq_octets(format_iq);
+    const long long timeout = (long long)TIMEOUT_MINUTE_S * f_iq;
+    int n;
+    
+    st.frames_decoded = 0;
+    st.last_frame = 0;
+    d = demod2g_cree(format_iq, f_iq, frame_sgb, &st);
+    brut = malloc((size_t)IQ_BLOC * octets);
+    if (!d || !brut || (mode_sgb == 2 && demod2g_fft(d, n_threads) != 0)) {
+        fprintf(stderr, "Error: Cannot set up 2G receiver\n");
+        demod2g_detruit(d);
+        free(brut);
+        return -1;
+    }
+    demod2g_affiche(d);
+    
+    while ((n = fread(brut, octets, IQ_BLOC, fp)) > 0) {
+        demod2g_alimente(d, brut, n);
+        
+        if (opt_minute == 1 && demod2g_position(d) - st.last_frame > timeout) {
+            fprintf(stderr, "Plus de 55s\n");
+            if (stop_on_timeout) break;
+            st.last_frame = demod2g_position(d);
+        }
+    }
+    
+    demod2g_detruit(d);
+    free(brut);
+    return st.frames_decoded;
+}
+
+// Raw IQ from a file, or from stdin when path is NULL
+int decode_iq_input(const char *path, int n_threads) {
+    DemodIQ iq;
+    FILE *fp = stdin;
+    int frames_decoded;
+    
+    if (f_iq <= 0) {
+        fprintf(stderr, "Error: IQ input needs --f_iq=F\n");
+        return 1;
+    }
+    if (f_centre_canaux > 0.0 || mode_sgb) {
+        if (path) {
+            fp = fopen(path, "rb");
+            if (!fp) {
+                fprintf(stderr, "Error: Cannot open file %s\n", path);
+                return 1;
+            }
+            printf("Processing IQ file: %s\n", path);
+        } else {
+            printf("Reading IQ from stdin...\n");
+            ancre_horloge();
+        }
+        frames_decoded = mode_sgb ? decode_sgb(fp, path != NULL, n_threads)
+                                  : decode_canaux(fp, path != NULL);
+        if (frames_decoded > 0) {
+            printf("\nTotal frames decoded: %d\n", frames_decoded);
+        } else if (frames_decoded == 0 && path) {
+            printf("No frames detected in file\n");
+        }
+        if (path) fclose(fp);
+        return frames_decoded < 0;
+    }
+    memset(&iq, 0, sizeof(iq));
+    if (iq_init(&iq, format_iq, f_iq, bande_iq) != 0) {
+        fprintf(stderr, "Error: Cannot set up IQ input\n");
+        return 1;
+    }
+    if (path) {
+        fp = fopen(path, "rb");
+        if (!fp) {
+            fprintf(stderr, "Error: Cannot open file %s\n", path);
+            iq_libere(&iq);
+            return 1;
+        }
+        printf("Processing IQ file: %s\n", path);
+    } else {
+        printf("Reading IQ from stdin...\n");
+        ancre_horloge();
+    }
+    printf("Channel filter +/-%.0f Hz, %d taps, phase at %d Hz\n",
+           bande_iq, iq.filtre.ntaps, iq.f_sortie);
+    
+    frames_decoded = decode_audio_stream(fp, NULL, path != NULL, &iq);
+    if (frames_decoded > 0) {
+        printf("\nTotal frames decoded: %d\n", frames_decoded);
+    } else if (path) {
+        printf("No frames detected in file\n");
+    }
+    
+    if (path) fclose(fp);
+    iq_libere(&iq);
+    return 0;
 }
 
 // ===================================================
@@ -163,6 +455,10 @@ int main(int argc, char *argv[]) {
     int is_wav_input = 0;
     char *input_arg = NULL;
     int show_help = 0;
+    char **inputs = malloc(argc * sizeof(char *));
+    int n_inputs = 0;
+    int n_threads = 0;
+    int threads_option = 0;
     
     // Initialize audio capture
     init_audio_capture();
@@ -172,12 +468,21 @@ int main(int argc, char *argv[]) {
         if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
             show_help = 1;
         }
+        else if (strncmp(argv[i], "--threads=", 10) == 0) {
+            n_threads = atoi(argv[i] + 10);
+            threads_option = 1;
+        }
         else if (argv[i][0] == '-') {
             // Option, will be processed by process_audio_options
             continue;
         }
-        else if (input_arg == NULL) {
-            input_arg = argv[i];
+        else {
+            if (input_arg == NULL) {
+                input_arg = argv[i];
+            }
+            if (inputs) {
+                inputs[n_inputs++] = argv[i];
+            }
         }
     }
     
@@ -190,6 +495,26 @@ int main(int argc, char *argv[]) {
     // Process audio options
     process_audio_options(argc, argv);
     
+    // Raw IQ input, from a file or stdin
+    if (format_iq != IQ_AUCUN) {
+        free(inputs);
+        return decode_iq_input(input_arg, n_threads);
+    }
+    
+    // Several recordings or a directory go to the worker pool
+    if (n_inputs > 1 || (n_inputs == 1 && is_directory(input_arg))) {
+        decode_lot(inputs, n_inputs, n_threads);
+        free(inputs);
+        return 0;
+    }
+    free(inputs);
+    
+    // A single recording with --threads is cut into segments
+    if (threads_option && input_arg != NULL && is_wav_file(input_arg)) {
+        decode_segments(input_arg, n_threads);
+        return 0;
+    }
+    
     // Determine input type
     if (input_arg != NULL) {
         if (is_hex_string(input_arg)) {
@@ -211,27 +536,28 @@ int main(int argc, char *argv[]) {
         decode_hex_string(input_arg);
     }
     else if (is_wav_input) {
-        // Open WAV file
-        input_file = fopen(input_arg, "rb");
-        if (!input_file) {
-            fprintf(stderr, "Error: Cannot open file %s\n", input_arg);
-            return 1;
-        }
-        
-        // Read WAV header
-        if (lit_entete_wav(input_file) != 0) {
-            fprintf(stderr, "Error: Invalid WAV file format\n");
-            fclose(input_file);
-            return 1;
+        // Map WAV file in memory, fall back to stream reading
+        WavMappe wav;
+        int is_mapped = (ouvre_wav_mmap(&wav, input_arg) == 0);
+        if (!is_mapped) {
+            input_file = fopen(input_arg, "rb");
+            if (!input_file) {
+                fprintf(stderr, "Error: Cannot open file %s\n", input_arg);
+                return 1;
+            }
+            
+            // Read WAV header
+            if (lit_entete_wav(input_file) != 0) {
+                fprintf(stderr, "Error: Invalid WAV file format\n");
+                fclose(input_file);
+                return 1;
+            }
         }
         
         // Capture and decode frames
         printf("Starting frame capture...\n");
-        int frames_decoded = 0;
-        while (capture_trame(input_file)) {
-            frames_decoded++;
-            printf("\n--- Frame %d decoded ---\n", frames_decoded);
-        }
+        int frames_decoded = decode_audio_stream(is_mapped ? NULL : input_file,
+                                                 is_mapped ? &wav : NULL, 1, NULL);
         
         if (frames_decoded == 0) {
             printf("No frames detected in file\n");
@@ -239,7 +565,11 @@ int main(int argc, char *argv[]) {
             printf("\nTotal frames decoded: %d\n", frames_decoded);
         }
         
-        fclose(input_file);
+        if (is_mapped) {
+            wav_mappe_ferme(&wav);
+        } else {
+            fclose(input_file);
+        }
     }
     else {
         // Read from stdin (pipe from sox)
@@ -247,7 +577,13 @@ int main(int argc, char *argv[]) {
         printf("Press Ctrl+C to stop\n\n");
         
         // Check if stdin is a WAV stream
-        if (lit_entete_wav(stdin) != 0) {
+        if (f_ech_raw > 0) {
+            f_ech = f_ech_raw;
+            bits = 16;
+            N_canaux = 1;
+            ech_par_bit = f_ech / bauds;
+        }
+        else if (lit_entete_wav(stdin) != 0) {
             // Not a WAV file, try raw samples
             printf("No WAV header detected, assuming raw audio\n");
             // Set default parameters for raw audio
@@ -257,19 +593,11 @@ int main(int argc, char *argv[]) {
             ech_par_bit = f_ech / bauds;
         }
         
+        // Live input: sample 0 is now unless --horodatage=T was given
+        ancre_horloge();
+        
         // Continuous capture loop
-        int frames_decoded = 0;
-        while (1) {
-            if (capture_trame(stdin)) {
-                frames_decoded++;
-                printf("\n--- Frame %d decoded ---\n", frames_decoded);
-            }
-            
-            // Check for EOF
-            if (feof(stdin)) {
-                break;
-            }
-        }
+        int frames_decoded = decode_audio_stream(stdin, NULL, 0, NULL);
         
         if (frames_decoded > 0) {
             printf("\nTotal frames decoded: %d\n", frames_decoded);
@@ -32,11 +32,11 @@ my @db;
 my $i;
 my $j;
 my $frq=0;
-my $dec = './dec406 --100 --M3';
-my $dec1 = './dec406 --100 --M3 --osm'; 
-my $filter = "lowpass 3000 highpass 10"; #highpass de 10Hz à 400Hz selon la qualité du signal
+my $dec = './dec406 --100 --banc';
+my $dec1 = './dec406 --100 --banc --osm'; 
+my $filter = "--filtre --passe_haut=10 --passe_bas=3000"; #highpass de 10Hz à 400Hz selon la qualité du signal
 
-my $largeur = "12k";
+my $largeur = "12000";
 my $WFM="";
 my $squelch=-200;
 my $snr = 6;
@@ -144,8 +144,7 @@ else {
     $utc = strftime(' %d %m %Y   %Hh%Mm%Ss', gmtime);
     print " UTC $utc";
     system("timeout 56s rtl_fm -p $ppm -M fm $WFM -s $largeur -f $frq  2>/dev/null |\ 
-	    sox -t raw -r $largeur -e s -b 16 -c 1 - -t wav - $filter 2>/dev/null |\ 
-	    $dec 1>./trame 2>./code ");  
+	    $dec --raw=$largeur $filter 1>./trame 2>./code ");  
       
     $trouve="PAS encore trouve";
     my $ligne;
@@ -2,6 +2,7 @@
 #include <stdint.h>
 #include <string.h>
 #include "dec406.h"
+#include "trame406.h"
 
 int main() {
     printf("=== TEST DU DECODEUR 2G AMELIORE ===\n");
@@ -112,8 +113,13 @@ int main() {
     // BCH error correction bits (bits 203-250): simplified for test
     for (int i = 202; i < 250; i++) test_frame[i] = 0;
     
+    // Trame compactée attendue par le décodeur
+    Trame406 trame;
+    trame406_efface(&trame, 250);
+    for (int i = 0; i < 250; i++) trame406_met(&trame, i, test_frame[i]);
+
     printf("Test avec trame 2G simulée (EPIRB française avec MMSI):\n");
-    decode_2g(test_frame);
+    decode_2g(&trame);
     
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,192 @@
+/**********************************
+
+## Licence
+
+ Licence Creative Commons CC BY-NC-SA 
+
+## Auteurs et contributions
+
+- **Code original dec406_v7** : F4EHY (2020)
+- **Refactoring et support 2G** : Développement collaboratif (2025)
+- **Conformité T.018** : Implémentation complète BCH + MID database
+
+***********************************/
+
+// test_bch.c - Self test of the BCH-1, BCH-2 and 2G BCH decoders
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "bch406.h"
+#include "trame406.h"
+
+#define ESSAIS 2000
+
+// ===================================================
+// Code under test
+// ===================================================
+// Codeword bits debut..debut+n-1 of a frame of longueur bits, the last
+// degre of them being the parity
+typedef struct {
+    const char *nom;
+    int longueur;
+    int debut;
+    int n;
+    uint64_t poly;      // Generator, x^degre term included
+    int degre;
+    int t;
+    uint64_t (*reste)(const Trame406 *t);
+    int (*corrige)(Trame406 *t);
+    int (*chase)(Trame406 *t, const uint8_t *fiabilite);
+} Code;
+
+static uint64_t reste1(const Trame406 *t) { return bch1_reste(t); }
+static uint64_t reste2(const Trame406 *t) { return bch2_reste(t); }
+
+static const Code codes[] = {
+    { "BCH-1 (82,61)", 144, BCH1_DEBUT, BCH1_N, BCH1_POLY, BCH1_DEGRE, 3,
+      reste1, bch1_corrige, bch1_chase },
+    { "BCH-2 (38,26)", 144, BCH2_DEBUT, BCH2_N, BCH2_POLY, BCH2_DEGRE, 2,
+      reste2, bch2_corrige, bch2_chase },
+    { "2G BCH (250,202)", BCH2G_N, 0, BCH2G_N, BCH2G_POLY, BCH2G_DEGRE, BCH2G_T,
+      bch2g_reste, bch2g_corrige, bch2g_chase },
+};
+
+// xorshift64, fixed seed so that a failure can be replayed
+static uint64_t graine = 0x9E3779B97F4A7C15ULL;
+
+static uint32_t aleatoire(uint32_t n) {
+    graine ^= graine << 13;
+    graine ^= graine >> 7;
+    graine ^= graine << 17;
+    return (uint32_t)((graine >> 11) % n);
+}
+
+// ===================================================
+// Helpers
+// ===================================================
+// Random frame bits, then the codeword parity from a bit-serial division
+// of the data bits, kept apart from the table-driven decoder under test
+static void encode(const Code *c, Trame406 *t) {
+    const uint64_t masque = (1ULL << c->degre) - 1;
+    uint64_t reg = 0;
+    int i;
+
+    trame406_efface(t, c->longueur);
+    for (i = 0; i < c->longueur; i++) {
+        trame406_met(t, i, aleatoire(2));
+    }
+    for (i = 0; i < c->n - c->degre; i++) {
+        int retour = (int)(reg >> (c->degre - 1)) ^ trame406_bit(t, c->debut + i);
+        reg = (reg << 1) & masque;
+        if (retour) reg ^= c->poly & masque;
+    }
+    for (i = 0; i < c->degre; i++) {
+        trame406_met(t, c->debut + c->n - 1 - i, (int)(reg >> i) & 1);
+    }
+}
+
+// Flip e distinct codeword bits, their positions returned in pos
+static void erreurs(const Code *c, Trame406 *t, int e, int *pos) {
+    int i, k;
+
+    for (i = 0; i < e; i++) {
+        do {
+            pos[i] = c->debut + (int)aleatoire(c->n);
+            for (k = 0; k < i && pos[k] != pos[i]; k++) {}
+        } while (k < i);
+        trame406_met(t, pos[i], !trame406_bit(t, pos[i]));
+    }
+}
+
+static int distance(const Trame406 *a, const Trame406 *b) {
+    int i, d = 0;
+
+    for (i = 0; i < TRAME406_MOTS; i++) {
+        d += __builtin_popcountll(a->mots[i] ^ b->mots[i]);
+    }
+    return d;
+}
+
+// ===================================================
+// Tests
+// ===================================================
+static int teste_code(const Code *c) {
+    Trame406 ref, t, recu;
+    uint8_t fiabilite[TRAME406_BITS_MAX];
+    int pos[BCH2G_T + 1];
+    int echecs = 0, rejets = 0, faux = 0, chase = 0;
+    int essai, e, ret, i;
+
+    for (essai = 0; essai < ESSAIS; essai++) {
+        encode(c, &ref);
+        if (c->reste(&ref) != 0) {
+            printf("  %s: encoder produced a non-codeword\n", c->nom);
+            return 1;
+        }
+
+        // Up to t errors are always corrected
+        e = essai % (c->t + 1);
+        t = ref;
+        erreurs(c, &t, e, pos);
+        ret = c->corrige(&t);
+        if (ret != e || distance(&t, &ref) != 0) {
+            if (echecs++ < 5) printf("  %s: %d errors, returned %d\n", c->nom, e, ret);
+        }
+
+        // t+1 errors are beyond the code: the frame is either left as
+        // received and rejected, or moved to another codeword within t
+        // bits (a bounded-distance decoder cannot tell that case apart)
+        t = ref;
+        erreurs(c, &t, c->t + 1, pos);
+        recu = t;
+        ret = c->corrige(&t);
+        if (ret < 0) {
+            rejets++;
+            if (distance(&t, &recu) != 0) {
+                if (echecs++ < 5) printf("  %s: rejected frame was modified\n", c->nom);
+            }
+        } else {
+            faux++;
+            if (ret > c->t || distance(&t, &recu) != ret || c->reste(&t) != 0 ||
+                distance(&t, &ref) == 0) {
+                if (echecs++ < 5) printf("  %s: %d errors, bad correction %d\n",
+                                         c->nom, c->t + 1, ret);
+            }
+        }
+
+        // Chase recovers t+1 errors flagged as the least reliable bits
+        memset(fiabilite, 128, sizeof(fiabilite));
+        for (i = 0; i <= c->t; i++) fiabilite[pos[i]] = (uint8_t)i;
+        t = recu;
+        ret = c->chase(&t, fiabilite);
+        if (ret >= 0 && distance(&t, &ref) == 0) chase++;
+    }
+
+    // Miscorrection of t+1 errors is rare for these codes; a rate this
+    // high means the decoder accepts what it should reject
+    if (rejets < ESSAIS / 2) {
+        printf("  %s: only %d of %d frames with %d errors rejected\n",
+               c->nom, rejets, ESSAIS, c->t + 1);
+        echecs++;
+    }
+    if (chase < ESSAIS * 9 / 10) {
+        printf("  %s: Chase recovered %d of %d frames\n", c->nom, chase, ESSAIS);
+        echecs++;
+    }
+    printf("%-18s t=%d  %s  (%d errors: %d rejected, %d miscorrected; Chase %d/%d)\n",
+           c->nom, c->t, echecs ? "FAIL" : "OK", c->t + 1, rejets, faux, chase, ESSAIS);
+    return echecs != 0;
+}
+
+int main(void) {
+    int echecs = 0;
+    size_t i;
+
+    printf("=== BCH self test, %d frames per code ===\n", ESSAIS);
+    for (i = 0; i < sizeof(codes) / sizeof(codes[0]); i++) {
+        echecs += teste_code(&codes[i]);
+    }
+    printf(echecs ? "BCH self test FAILED\n" : "BCH self test passed\n");
+    return echecs ? 1 : 0;
+}
@@ -0,0 +1,97 @@
+/**********************************
+
+## Licence
+
+ Licence Creative Commons CC BY-NC-SA 
+
+## Auteurs et contributions
+
+- **Code original dec406_v7** : F4EHY (2020)
+- **Refactoring et support 2G** : Développement collaboratif (2025)
+- **Conformité T.018** : Implémentation complète BCH + MID database
+
+***********************************/
+
+// trame406.c - Packed beacon frame shared by the 1G and 2G decoders
+#include <string.h>
+#include <ctype.h>
+#include "trame406.h"
+
+void trame406_efface(Trame406 *t, int longueur) {
+    memset(t->mots, 0, sizeof(t->mots));
+    t->longueur = longueur;
+}
+
+void trame406_tronque(Trame406 *t, int longueur) {
+    int m;
+
+    for (m = 0; m < TRAME406_MOTS; m++) {
+        const int d = longueur - 64 * m;
+        if (d <= 0) {
+            t->mots[m] = 0;
+        } else if (d < 64) {
+            t->mots[m] &= ~0ULL << (64 - d);
+        }
+    }
+    t->longueur = longueur;
+}
+
+void trame406_pose(Trame406 *t, int debut, int n, uint32_t v) {
+    const int m = debut >> 6, d = debut & 63;
+    const uint64_t masque = (1ULL << n) - 1;
+    const uint64_t val = v & masque;
+
+    if (d + n <= 64) {
+        const int s = 64 - d - n;
+        t->mots[m] = (t->mots[m] & ~(masque << s)) | (val << s);
+    } else {
+        // Field straddles two words
+        const int r = d + n - 64;
+        t->mots[m] = (t->mots[m] & ~(masque >> r)) | (val >> r);
+        t->mots[m + 1] = (t->mots[m + 1] & ~(masque << (64 - r))) | (val << (64 - r));
+    }
+}
+
+int trame406_depuis_hex(Trame406 *t, const char *hex, int debut) {
+    int invalides = 0;
+    int i, j;
+
+    for (i = 0; hex[i]; i++) {
+        const int c = tolower((unsigned char)hex[i]);
+        int v = 0;
+        if (c >= 'a' && c <= 'f') {
+            v = c - 'a' + 10;
+        } else if (c >= '0' && c <= '9') {
+            v = c - '0';
+        } else {
+            invalides++;
+        }
+
+        const int pos = debut + 4 * i;
+        if (pos >= 0 && pos + 4 <= t->longueur) {
+            trame406_pose(t, pos, 4, v);
+        } else {
+            for (j = 0; j < 4; j++) {
+                if (pos + j >= 0 && pos + j < t->longueur) {
+                    trame406_met(t, pos + j, (v >> (3 - j)) & 1);
+                }
+            }
+        }
+    }
+    return invalides;
+}
+
+void trame406_hex(const Trame406 *t, int debut, int n, int majuscules, char *hex) {
+    const char *chiffres = majuscules ? "0123456789ABCDEF" : "0123456789abcdef";
+    int i;
+
+    for (i = 0; 4 * i < n; i++) {
+        const int reste = n - 4 * i;
+        if (reste >= 4) {
+            hex[i] = chiffres[trame406_champ(t, debut + 4 * i, 4)];
+        } else {
+            hex[i] = chiffres[trame406_champ(t, debut + 4 * i, reste) << (4 - reste)];
+        }
+    }
+    hex[i] = '\0';
+}
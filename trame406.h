@@ -0,0 +1,112 @@
+/**********************************
+
+## Licence
+
+ Licence Creative Commons CC BY-NC-SA 
+
+## Auteurs et contributions
+
+- **Code original dec406_v7** : F4EHY (2020)
+- **Refactoring et support 2G** : Développement collaboratif (2025)
+- **Conformité T.018** : Implémentation complète BCH + MID database
+
+***********************************/
+
+// trame406.h - Packed beacon frame shared by the 1G and 2G decoders
+#ifndef TRAME406_H
+#define TRAME406_H
+
+#include <stdint.h>
+
+#define TRAME406_BITS_MAX 256
+#define TRAME406_MOTS (TRAME406_BITS_MAX / 64)
+
+// ===================================================
+// Packed frame
+// ===================================================
+// Bit 1 of the frame (index 0) is the most significant bit of mots[0].
+// Bits past the length stay at zero.
+typedef struct {
+    uint64_t mots[TRAME406_MOTS];
+    int longueur;               // 112 or 144 (1G), 250 (2G)
+} Trame406;
+
+/**
+ * Read one bit
+ * @param t Frame
+ * @param i Bit index, 0-indexed
+ * @return 0 or 1
+ */
+static inline int trame406_bit(const Trame406 *t, int i) {
+    return (int)(t->mots[i >> 6] >> (63 - (i & 63))) & 1;
+}
+
+/**
+ * Write one bit
+ * @param t Frame
+ * @param i Bit index, 0-indexed
+ * @param v 0 or 1
+ */
+static inline void trame406_met(Trame406 *t, int i, int v) {
+    const uint64_t m = 1ULL << (63 - (i & 63));
+    t->mots[i >> 6] = v ? (t->mots[i >> 6] | m) : (t->mots[i >> 6] & ~m);
+}
+
+/**
+ * Read a field, at most two words whatever its width
+ * @param t Frame
+ * @param debut First bit, 0-indexed
+ * @param n Width, 1 to 32 bits
+ * @return Field value, first bit most significant
+ */
+static inline uint32_t trame406_champ(const Trame406 *t, int debut, int n) {
+    const int m = debut >> 6, d = debut & 63;
+    uint64_t v = t->mots[m] << d;
+    if (d + n > 64) v |= t->mots[m + 1] >> (64 - d);
+    return (uint32_t)(v >> (64 - n));
+}
+
+/**
+ * Clear a frame
+ * @param t Frame
+ * @param longueur Frame length in bits, at most TRAME406_BITS_MAX
+ */
+void trame406_efface(Trame406 *t, int longueur);
+
+/**
+ * Set the length and clear the bits past it
+ * @param t Frame
+ * @param longueur New length in bits
+ */
+void trame406_tronque(Trame406 *t, int longueur);
+
+/**
+ * Write a field
+ * @param t Frame
+ * @param debut First bit, 0-indexed
+ * @param n Width, 1 to 32 bits
+ * @param v Field value, first bit most significant
+ */
+void trame406_pose(Trame406 *t, int debut, int n, uint32_t v);
+
+/**
+ * Write hexadecimal digits, four bits each, into a cleared frame
+ * @param t Frame, length already set
+ * @param hex Digits, upper or lower case
+ * @param debut Frame bit of the first digit's top bit; bits landing
+ *              outside the frame are dropped, so -2 skips two pad bits
+ * @return Number of characters that were not hex digits (read as 0)
+ */
+int trame406_depuis_hex(Trame406 *t, const char *hex, int debut);
+
+/**
+ * Format bits as hexadecimal, a short last digit padded with zeros
+ * @param t Frame
+ * @param debut First bit, 0-indexed
+ * @param n Number of bits
+ * @param majuscules Upper case digits if non-zero
+ * @param hex Output, at least (n + 3) / 4 + 1 characters
+ */
+void trame406_hex(const Trame406 *t, int debut, int n, int majuscules, char *hex);
+
+#endif // TRAME406_H